@@ -0,0 +1,87 @@
+/**
+ * @file     bench.h
+ * @brief    common helpers of benchmarks
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Each measured case is run `BENCH_REPS` times and the best time is
+ * reported as one JSON object per line on the standard output:
+ *
+ *        {"bench": "stk_push", "case": "int", "param": 128, "ns_per_op": 4.2}
+ *
+ * so results of all benchmarks can be collected into one JSON lines file
+ * and compared to a baseline (see compare.sh).
+ */
+
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+
+#include <stdio.h>
+#include <time.h>
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of repetitions of each case, the best of which is reported */
+#ifndef BENCH_REPS
+#  define BENCH_REPS 5
+#endif
+
+
+/**
+ * measures and reports a case
+ *
+ * @param  bench     name of benchmark group
+ * @param  name      name of case
+ * @param  param     numeric parameter of case (size, length, etc.)
+ * @param  nOps      number of operations performed by body
+ * @param  setup     statement to run before each repetition, not measured
+ * @param  body      statement to measure
+ * @param  teardown  statement to run after each repetition, not measured
+ */
+#define BENCH(bench, name, param, nOps, setup, body, teardown)                \
+do {                                                                          \
+    double __best = 0, __t;                                                   \
+    int __r;                                                                  \
+                                                                              \
+    for(__r = 0; __r < BENCH_REPS; __r++) {                                   \
+        setup;                                                                \
+        __t = benchNow();                                                     \
+        body;                                                                 \
+        __t = benchNow() - __t;                                               \
+        teardown;                                                             \
+        if(__r == 0 || __t < __best)                                          \
+            __best = __t;                                                     \
+    }                                                                         \
+    benchReport(bench, name, param, __best / (nOps));                         \
+} while(0)
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** gets monotonic time in nanoseconds */
+static inline double benchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/** prints result of a case as a JSON line */
+static inline void benchReport(const char *bench, const char *name,
+                               long param, double nsPerOp)
+{
+    printf("{\"bench\": \"%s\", \"case\": \"%s\", \"param\": %ld, "
+           "\"ns_per_op\": %.3f}\n", bench, name, param, nsPerOp);
+    fflush(stdout);
+}
+
+
+#endif /* __BENCH_H */
@@ -0,0 +1,59 @@
+#!/bin/sh
+## ===========================================================================
+## @file    compare.sh
+## @brief   compares benchmark results to a baseline
+## @author  Tamas Dezso
+## @date    October 18, 2026
+##
+## Usage: compare.sh BASELINE CURRENT [TOLERANCE]
+##
+## Both files hold JSON lines as printed by the benchmarks (see bench.h).
+## Cases are matched by bench, case and param; each is printed with its
+## baseline and current ns/op and the change in percent. Exits with 1 if
+## any case got slower by more than TOLERANCE percent (default: 10).
+## ===========================================================================
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 BASELINE CURRENT [TOLERANCE]" >&2
+    exit 2
+fi
+
+awk -v tol="${3:-10}" '
+# gets value of a field from a JSON line as printed by benchReport()
+function field(line, name,    v) {
+    if(!match(line, "\"" name "\": *(\"[^\"]*\"|[-0-9.e+]+)"))
+        return ""
+    v = substr(line, RSTART, RLENGTH)
+    sub(/^"[^"]*": */, "", v)
+    gsub(/"/, "", v)
+    return v
+}
+
+{
+    key = field($0, "bench") " " field($0, "case") " " field($0, "param")
+    ns = field($0, "ns_per_op")
+    if(ns == "")
+        next
+}
+
+FILENAME == ARGV[1] { base[key] = ns; next }
+
+{
+    if(!(key in base)) {
+        printf "%-44s %10s %10.3f %8s\n", key, "-", ns, "new"
+        next
+    }
+    d = base[key] > 0 ? (ns - base[key]) * 100 / base[key] : 0
+    flag = d > tol ? "  REGRESSION" : ""
+    printf "%-44s %10.3f %10.3f %+7.1f%%%s\n", key, base[key], ns, d, flag
+    if(flag != "")
+        bad++
+}
+
+END {
+    if(bad) {
+        printf "%d case(s) slower by more than %s%%\n", bad, tol
+        exit 1
+    }
+}
+' "$1" "$2"
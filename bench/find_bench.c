@@ -0,0 +1,104 @@
+/**
+ * @file     find_bench.c
+ * @brief    expanding stack search and count benchmark
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Compares `stkFind()` and `stkCountType()` on each available SIMD level
+ * with a walk over the same elements linked one by one (list.h) and
+ * scattered on the heap, as elements used to be kept on the stack.
+ * Results are JSON lines, see bench.h.
+ */
+
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "list.h"
+#include "stk.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of elements searched */
+#define DEPTH  1000000
+
+/** number of searches measured */
+#define ROUNDS 10
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct node_t node_t;
+struct node_t
+{
+    stkEl_t el;
+    node_t *LIST_LINK;
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+int main(void)
+{
+    static const char *levels[] = { "scalar", "sse2", "avx2" };
+    stk_t *s = stkNew(128);
+    node_t **nodes = malloc(sizeof(*nodes) * DEPTH);
+    node_t *head = NULL, *pos;
+    volatile size_t sink = 0;
+    int level, max, r, i;
+
+    /* same mixed content on stack and on scattered linked nodes */
+    for(i = 0; i < DEPTH; i++) {
+        stkEl_t *el = i % 3 ? stkPushInt(s, i) : stkPushPtr(s, &nodes[i]);
+
+        nodes[i] = malloc(sizeof(*nodes[i]));
+        nodes[i]->el = *el;
+    }
+    for(i = DEPTH-1; i > 0; i--) {
+        int j = rand() % (i+1);
+        node_t *tmp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = tmp;
+    }
+    for(i = 0; i < DEPTH; i++)
+        listAdd(nodes[i], head);
+
+    /* count */
+    BENCH("stk_count", "linked_walk", DEPTH, (double)ROUNDS * DEPTH, ,
+          for(r = 0; r < ROUNDS; r++)
+              listForEach(pos, head)
+                  sink += pos->el.type == 'i', );
+
+    max = stkSetSimd(-1);
+    for(level = STK_SIMD_NONE; level <= max; level++) {
+        stkSetSimd(level);
+        BENCH("stk_count", levels[level], DEPTH, (double)ROUNDS * DEPTH, ,
+              for(r = 0; r < ROUNDS; r++)
+                  sink += stkCountType(s, 'i'), );
+    }
+
+    /* find missing value, so each search scans everything */
+    BENCH("stk_find", "linked_walk", DEPTH, (double)ROUNDS * DEPTH, ,
+          for(r = 0; r < ROUNDS; r++)
+              listForEach(pos, head)
+                  if(pos->el.type == 'p' && pos->el.var.p == NULL)
+                      break, );
+
+    for(level = STK_SIMD_NONE; level <= max; level++) {
+        stkSetSimd(level);
+        BENCH("stk_find", levels[level], DEPTH, (double)ROUNDS * DEPTH, ,
+              for(r = 0; r < ROUNDS; r++)
+                  sink += stkFindPtr(s, NULL) != NULL, );
+    }
+
+    for(i = 0; i < DEPTH; i++)
+        free(nodes[i]);
+    free(nodes);
+    stkDestroy(s);
+    return 0;
+}
@@ -0,0 +1,471 @@
+/**
+ * @file     list_bench.c
+ * @brief    singly linked list benchmarks
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Measures building lists at head and at tail (walking, or through a
+ * head/tail descriptor), and finding entries by key with `listFind()` and
+ * with the self-organizing `listFindCache()`, on lists of different
+ * lengths, and in a hash table (hash.h) for reference. Keys looked up are
+ * either uniform or skewed towards a few hot ones, where moving to front
+ * pays off. Sorting in place by `listSort()` is compared to sorting an
+ * array of entry pointers and relinking them, and keeping entries ordered
+ * by walking to their places or by a skip list (skip.h). Producer threads
+ * adding to a list drained by one consumer use either a mutex or
+ * `listAddAtomic()` and `listTakeAll()`. Walking long lists of entries
+ * scattered in memory, with and without prefetching ahead, is measured
+ * with little and with some work per entry. Results are JSON lines, see
+ * bench.h.
+ */
+
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "bench.h"
+#include "list.h"
+#include "hash.h"
+#include "skip.h"
+#include "ulist.h"
+#include "ilist.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of lookups measured */
+#define LOOKUPS 10000
+
+/** number of entries added by each producer thread, and most threads */
+#define MPSC_ADDS    100000
+#define MPSC_MAX     4
+
+/** most entries of lists walked with prefetching */
+#define SCATTER_MAX  10000000
+
+/** most entries of lists scanned unrolled, and entries per node */
+#define UNROLL_MAX   1000000
+#define UNROLL_K     14
+
+/** compares key of an entry */
+#define KEYCMP(a, b)  ((a) != (b))
+
+/** hashes key of an entry */
+#define KEYHASH(a)    ((unsigned long)(a) * 2654435761u)
+
+/** orders keys of entries */
+#define KEYORD(a, b)  (((a) > (b)) - ((a) < (b)))
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct node_t node_t;
+struct node_t
+{
+    int key;
+    node_t *LIST_LINK;
+    node_t *LIST_LINK_(hash);
+    SKIP_LINKS(node_t, skip);
+};
+
+
+typedef struct scatter_t scatter_t;
+struct scatter_t
+{
+    long key;
+    long pad[6];
+    scatter_t *LIST_LINK;
+
+}; /* entry of a cache line of its own */
+
+
+typedef struct small_t small_t;
+struct small_t
+{
+    int key;
+    small_t *LIST_LINK;
+
+}; /* entry allocated on its own */
+
+
+typedef struct ismall_t ismall_t;
+struct ismall_t
+{
+    int key;
+    uint32_t ILIST_LINK;
+
+}; /* entry of an array, linked by index */
+
+
+typedef struct producer_t producer_t;
+struct producer_t
+{
+    node_t *nodes;              /* entries to add */
+    int locked;                 /* adding under the mutex, not atomically */
+};
+
+
+/* ----- globals ----------------------------------------------------------- */
+
+
+/** keys to look up, uniform and skewed */
+static int _uniform[LOOKUPS], _skewed[LOOKUPS];
+
+/** sink of results, to keep them from being optimized out */
+static volatile long _sink;
+
+/** list shared by producers and consumer, and its mutex if locked */
+static node_t *_shared;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** fills array with keys 0..n-1 in random order */
+static void shuffle(node_t *nodes, int n)
+{
+    int i;
+
+    for(i = 0; i < n; i++)
+        nodes[i].key = i;
+    for(i = n-1; i > 0; i--) {
+        int j = rand() % (i+1), tmp = nodes[i].key;
+        nodes[i].key = nodes[j].key;
+        nodes[j].key = tmp;
+    }
+}
+
+
+/** orders entry pointers by key for qsort() */
+static int nodeOrd(const void *a, const void *b)
+{
+    return KEYORD((*(node_t * const *)a)->key, (*(node_t * const *)b)->key);
+}
+
+
+/** sorts list the way it is done without listSort(): copy, qsort, relink */
+static node_t *sortByArray(node_t *head, node_t **ptrs)
+{
+    node_t *pos;
+    int n = 0, i;
+
+    listForEach(pos, head)
+        ptrs[n++] = pos;
+    qsort(ptrs, n, sizeof(*ptrs), nodeOrd);
+    for(i = 0; i < n-1; i++)
+        ptrs[i]->LIST_LINK = ptrs[i+1];
+    ptrs[n-1]->LIST_LINK = NULL;
+    return ptrs[0];
+}
+
+
+/** adds entry in order the way it is done without skip.h: walk, insert */
+static void addOrdered(node_t *new, node_t **head)
+{
+    node_t **pos;
+
+    listForEachLink(pos, head)
+        if((*pos)->key > new->key)
+            break;
+    new->LIST_LINK = *pos;
+    *pos = new;
+}
+
+
+/** builds, then searches lists of n entries */
+static void benchLen(int n)
+{
+    node_t *nodes = malloc(sizeof(*nodes) * n);
+    node_t **ptrs = malloc(sizeof(*ptrs) * n);
+    node_t *head = NULL;
+    LIST_DESC(, node_t) desc;
+    HASH_TABLE(node_t) tbl;
+    SKIP_LIST(node_t) sl, empty = SKIP_LIST_INIT;
+    int i, k;
+
+    shuffle(nodes, n);
+    for(k = 0; k < LOOKUPS; k++) {
+        double r = (double)rand() / RAND_MAX;
+        _uniform[k] = rand() % n;
+        _skewed[k] = (int)(r * r * r * (n-1)); /* mostly low keys */
+    }
+
+    BENCH("list_build", "add", n, n,
+          head = NULL,
+          for(i = 0; i < n; i++) listAdd(&nodes[i], head), );
+    BENCH("list_build", "add_tail", n, n,
+          head = NULL,
+          for(i = 0; i < n; i++) listAddTail(&nodes[i], head), );
+    BENCH("list_build", "desc_add_tail", n, n,
+          desc.head = desc.tail = NULL,
+          for(i = 0; i < n; i++) listDescAddTail(&nodes[i], desc), );
+
+    BENCH("list_find", "uniform", n, LOOKUPS, ,
+          for(k = 0; k < LOOKUPS; k++)
+              _sink += (long)listFind(head,, KEYCMP, ->key, _uniform[k]), );
+    BENCH("list_find", "skewed", n, LOOKUPS, ,
+          for(k = 0; k < LOOKUPS; k++)
+              _sink += (long)listFind(head,, KEYCMP, ->key, _skewed[k]), );
+
+    /* table grown from a single bucket, moving buckets over as it goes */
+    BENCH("hash_build", "add", n, n,
+          hashInit(tbl, 1),
+          for(i = 0; i < n; i++)
+              hashAdd(&nodes[i], tbl, hash, KEYHASH, ->key),
+          hashDestroy(tbl));
+    hashInit(tbl, 1);
+    for(i = 0; i < n; i++)
+        hashAdd(&nodes[i], tbl, hash, KEYHASH, ->key);
+    BENCH("hash_find", "uniform", n, LOOKUPS, ,
+          for(k = 0; k < LOOKUPS; k++)
+              _sink += (long)hashFind(tbl, hash, KEYHASH, KEYCMP, ->key,
+                                      _uniform[k]), );
+    hashDestroy(tbl);
+
+    /* each repetition starts over from the original order */
+    BENCH("list_find_cache", "uniform", n, LOOKUPS,
+          head = NULL; for(i = 0; i < n; i++) listAdd(&nodes[i], head),
+          for(k = 0; k < LOOKUPS; k++)
+              _sink += (long)listFindCache(head,, KEYCMP, ->key, _uniform[k]),
+          );
+    BENCH("list_find_cache", "skewed", n, LOOKUPS,
+          head = NULL; for(i = 0; i < n; i++) listAdd(&nodes[i], head),
+          for(k = 0; k < LOOKUPS; k++)
+              _sink += (long)listFindCache(head,, KEYCMP, ->key, _skewed[k]),
+          );
+
+    /* each repetition sorts the original order */
+    BENCH("list_sort", "merge_sort", n, n,
+          head = NULL; for(i = 0; i < n; i++) listAdd(&nodes[i], head),
+          listSort(head,, KEYORD, ->key), );
+    BENCH("list_sort", "qsort_relink", n, n,
+          head = NULL; for(i = 0; i < n; i++) listAdd(&nodes[i], head),
+          head = sortByArray(head, ptrs), );
+
+    /* entries coming in random order, e.g., timers */
+    BENCH("ordered_build", "list_walk", n, n,
+          head = NULL,
+          for(i = 0; i < n; i++) addOrdered(&nodes[i], &head), );
+    BENCH("ordered_build", "skip_add", n, n,
+          sl = empty,
+          for(i = 0; i < n; i++) skipAdd(&nodes[i], sl, skip, KEYORD, ->key),
+          );
+    BENCH("ordered_find", "skip_find", n, LOOKUPS, ,
+          for(k = 0; k < LOOKUPS; k++)
+              _sink += (long)skipFind(sl, skip, KEYORD, ->key, _uniform[k]),
+          );
+
+    free(ptrs);
+    free(nodes);
+}
+
+
+/** does dependent arithmetic on a key, about as long as a cache miss */
+static inline long work(long k)
+{
+    int j;
+
+    for(j = 0; j < 32; j++)
+        k = k * 6364136223846793005L + 1442695040888963407L;
+    return k;
+}
+
+
+/** walks and searches a list of n entries linked in random order */
+static void benchScatter(int n)
+{
+    scatter_t *nodes = malloc(sizeof(*nodes) * n), *head = NULL, *pos, *ahead;
+    int *order = malloc(sizeof(*order) * n);
+    long sum = 0;
+    int i;
+
+    /* each hop to a random place, most of them cache misses */
+    for(i = 0; i < n; i++)
+        order[i] = i;
+    for(i = n-1; i > 0; i--) {
+        int j = rand() % (i+1), tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for(i = 0; i < n; i++) {
+        nodes[order[i]].key = i;
+        listAdd(&nodes[order[i]], head);
+    }
+
+    BENCH("list_walk", "plain", n, n, sum = 0,
+          listForEach(pos, head) sum += pos->key, _sink += sum);
+    BENCH("list_walk", "prefetch", n, n, sum = 0,
+          listForEachPrefetch(pos, ahead, head) sum += pos->key,
+          _sink += sum);
+    BENCH("list_walk_work", "plain", n, n, sum = 0,
+          listForEach(pos, head) sum += work(pos->key), _sink += sum);
+    BENCH("list_walk_work", "prefetch", n, n, sum = 0,
+          listForEachPrefetch(pos, ahead, head) sum += work(pos->key),
+          _sink += sum);
+    BENCH("list_find_miss", "plain", n, n, ,
+          _sink += (long)listFind(head,, KEYCMP, ->key, -1), );
+    BENCH("list_find_miss", "prefetch", n, n, ,
+          _sink += (long)listFindPrefetch(head,, KEYCMP, ->key, -1), );
+
+    free(order);
+    free(nodes);
+}
+
+
+/** scans a list of n small entries, linked one by one and unrolled */
+static void benchUnrolled(int n)
+{
+    ULIST(int, UNROLL_K) ul = ULIST_INIT;
+    ULIST_NODE(ul) node;
+    small_t *head = NULL, *pos, *tmp;
+    int *el, i;
+    long sum = 0;
+
+    for(i = 0; i < n; i++) {
+        pos = malloc(sizeof(*pos));
+        pos->key = i;
+        listAdd(pos, head);
+        ulistAdd(ul, i);
+    }
+
+    BENCH("unrolled_scan", "list", n, n, sum = 0,
+          listForEach(pos, head) sum += pos->key, _sink += sum);
+    BENCH("unrolled_scan", "ulist", n, n, sum = 0,
+          ulistForEach(el, node, ul) sum += *el, _sink += sum);
+    BENCH("unrolled_find_miss", "list", n, n, ,
+          _sink += (long)listFind(head,, KEYCMP, ->key, -1), );
+    BENCH("unrolled_find_miss", "ulist", n, n, ,
+          _sink += (long)ulistFind(ul, KEYCMP, [0], -1), );
+
+    listForEachSafe(pos, tmp, head)
+        free(pos);
+    ulistDestroy(ul);
+}
+
+
+/** walks and searches lists of n small entries of an array linked in
+ *  random order, by pointers and by indices */
+static void benchIndexed(int n)
+{
+    small_t *nodes = malloc(sizeof(*nodes) * n), *head = NULL, *pos;
+    ismall_t *inodes = malloc(sizeof(*inodes) * n), *ipos;
+    uint32_t ihead = ILIST_NIL;
+    int *order = malloc(sizeof(*order) * n);
+    long sum = 0;
+    int i;
+
+    for(i = 0; i < n; i++)
+        order[i] = i;
+    for(i = n-1; i > 0; i--) {
+        int j = rand() % (i+1), tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for(i = 0; i < n; i++) {
+        nodes[order[i]].key = inodes[order[i]].key = i;
+        listAdd(&nodes[order[i]], head);
+        ilistAdd(&inodes[order[i]], inodes, ihead);
+    }
+
+    BENCH("indexed_walk", "pointer", n, n, sum = 0,
+          listForEach(pos, head) sum += pos->key, _sink += sum);
+    BENCH("indexed_walk", "index", n, n, sum = 0,
+          ilistForEach(ipos, inodes, ihead) sum += ipos->key, _sink += sum);
+    BENCH("indexed_find_miss", "pointer", n, n, ,
+          _sink += (long)listFind(head,, KEYCMP, ->key, -1), );
+    BENCH("indexed_find_miss", "index", n, n, ,
+          _sink += (long)ilistFind(inodes, ihead,, KEYCMP, ->key, -1), );
+
+    free(order);
+    free(inodes);
+    free(nodes);
+}
+
+
+/** adds entries of a producer to the shared list */
+static void *produce(void *arg)
+{
+    producer_t *p = arg;
+    int i;
+
+    for(i = 0; i < MPSC_ADDS; i++)
+        if(p->locked) {
+            pthread_mutex_lock(&_lock);
+            listAdd(&p->nodes[i], _shared);
+            pthread_mutex_unlock(&_lock);
+        } else
+            listAddAtomic(&p->nodes[i], _shared);
+    return NULL;
+}
+
+
+/** runs producers adding to the shared list while draining it */
+static void mpscRun(producer_t *prods, int nProds)
+{
+    pthread_t tids[MPSC_MAX];
+    node_t *taken, *pos;
+    long n = 0;
+    int i;
+
+    for(i = 0; i < nProds; i++)
+        pthread_create(&tids[i], NULL, produce, &prods[i]);
+    while(n < (long)nProds * MPSC_ADDS) {
+        if(prods[0].locked) {
+            pthread_mutex_lock(&_lock);
+            taken = _shared;
+            _shared = NULL;
+            pthread_mutex_unlock(&_lock);
+        } else
+            taken = listTakeAll(_shared);
+        listForEach(pos, taken)
+            n++;
+    }
+    for(i = 0; i < nProds; i++)
+        pthread_join(tids[i], NULL);
+}
+
+
+/** adds from nProds threads, with the mutex and atomically */
+static void benchMpsc(int nProds)
+{
+    node_t *nodes = malloc(sizeof(*nodes) * nProds * MPSC_ADDS);
+    producer_t prods[MPSC_MAX];
+    int i;
+
+    for(i = 0; i < nProds; i++)
+        prods[i].nodes = nodes + i * MPSC_ADDS;
+
+    BENCH("mpsc_add", "mutex", nProds, (long)nProds * MPSC_ADDS,
+          for(i = 0; i < nProds; i++) prods[i].locked = 1,
+          mpscRun(prods, nProds), );
+    BENCH("mpsc_add", "atomic", nProds, (long)nProds * MPSC_ADDS,
+          for(i = 0; i < nProds; i++) prods[i].locked = 0,
+          mpscRun(prods, nProds), );
+
+    free(nodes);
+}
+
+
+int main(void)
+{
+    static const int lens[] = { 10, 100, 1000, 10000 };
+    size_t l;
+
+    srand(1);
+    for(l = 0; l < sizeof(lens)/sizeof(lens[0]); l++)
+        benchLen(lens[l]);
+    for(l = 1; l <= MPSC_MAX; l *= 2)
+        benchMpsc(l);
+    for(l = 10000; l <= SCATTER_MAX; l *= 10)
+        benchScatter(l);
+    for(l = 10000; l <= SCATTER_MAX; l *= 10)
+        benchIndexed(l);
+    for(l = 10000; l <= UNROLL_MAX; l *= 10)
+        benchUnrolled(l);
+
+    return 0;
+}
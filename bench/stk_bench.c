@@ -0,0 +1,330 @@
+/**
+ * @file     stk_bench.c
+ * @brief    expanding stack throughput benchmarks
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Measures push/pop throughput by type and block size, both through the
+ * inline fast path (`stkPushXxx()`) and dispatched at run time by the
+ * out-of-line `_stkPush()` (`stkPush()`), string-heavy workloads with
+ * and without recycling of popped buffers, call frames, and the cost of
+ * short-lived stacks, clear and destroy; baselines are a plain realloc'd
+ * array and nodes malloc'd one by one (list.h). Results are JSON lines,
+ * see bench.h.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "list.h"
+#include "stk.h"
+#include "stkpool.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of elements pushed (then popped) in a round */
+#define DEPTH  100000
+
+/** number of rounds in a push/pop measurement */
+#define ROUNDS 10
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct node_t node_t;
+struct node_t
+{
+    stkEl_t el;
+    node_t *LIST_LINK;
+};
+
+
+/* ----- globals ----------------------------------------------------------- */
+
+
+/** lengths of strings to push (with terminating null) */
+static const int _lens[] = { 8, 64, 512 };
+
+/** strings of different lengths to push */
+static char _str[3][512];
+
+/** sink of popped values, to keep them from being optimized out */
+static volatile int _sink;
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** measures push+pop rounds on one stack, reports ns per push and pop */
+#define PUSH_POP(bench, name, blkSz, push)                                    \
+{                                                                             \
+    stk_t *s = stkNew(blkSz);                                                 \
+    int r, i;                                                                 \
+                                                                              \
+    BENCH(bench, name, blkSz, (double)ROUNDS * DEPTH, ,                       \
+          for(r = 0; r < ROUNDS; r++) {                                       \
+              for(i = 0; i < DEPTH; i++)                                      \
+                  push;                                                       \
+              while(stkPop(s))                                                \
+                  ;                                                           \
+          }, );                                                               \
+    stkDestroy(s);                                                            \
+}
+
+
+/** push/pop of each type on different block sizes */
+static void benchPushPop(void)
+{
+    static const size_t blkSzs[] = { 16, 128, 1024 };
+    size_t b;
+
+    for(b = 0; b < sizeof(blkSzs)/sizeof(blkSzs[0]); b++)
+    {
+        PUSH_POP("stk_push_pop", "int", blkSzs[b], stkPushInt(s, i));
+        PUSH_POP("stk_push_pop", "dbl", blkSzs[b], stkPushDbl(s, i));
+        PUSH_POP("stk_push_pop", "chr", blkSzs[b], stkPushChr(s, i));
+        PUSH_POP("stk_push_pop", "ptr", blkSzs[b], stkPushPtr(s, &i));
+        PUSH_POP("stk_push_pop", "int_generic", blkSzs[b],
+                 stkPush(s, 'i', i));
+        PUSH_POP("stk_push_pop", "ptr_generic", blkSzs[b],
+                 stkPush(s, 'p', (void *)&i));
+    }
+}
+
+
+/** push/pop of strings of different lengths, freed at once or recycled */
+static void benchStrings(void)
+{
+    static const char *names[][2] = {
+        { "push_pop", "interleaved" },
+        { "push_pop_recycle", "interleaved_recycle" },
+    };
+    size_t l, rc;
+
+    for(l = 0; l < sizeof(_lens)/sizeof(_lens[0]); l++)
+        for(rc = 0; rc < 2; rc++)
+        {
+            stk_t *s = stkNew(128);
+            const char *str = _str[l];
+            int r, i;
+
+            stkStrRecycle(s, rc ? (size_t)DEPTH * 1024 : 0);
+
+            BENCH("stk_str", names[rc][0], _lens[l], (double)ROUNDS * DEPTH, ,
+                  for(r = 0; r < ROUNDS; r++) {
+                      for(i = 0; i < DEPTH; i++)
+                          stkPushStr(s, str);
+                      while(stkPop(s))
+                          ;
+                  }, );
+
+            /* interleaved, as in parsers */
+            BENCH("stk_str", names[rc][1], _lens[l], (double)ROUNDS * DEPTH, ,
+                  for(r = 0; r < ROUNDS; r++) {
+                      for(i = 0; i < DEPTH; i++) {
+                          stkPushStr(s, str);
+                          stkPushStr(s, str);
+                          stkPop(s);
+                          if(i % 2)
+                              stkPop(s);
+                      }
+                      while(stkPop(s))
+                          ;
+                  }, );
+            stkDestroy(s);
+        }
+}
+
+
+/** call frames pushed value by value and as a whole */
+static void benchFrames(void)
+{
+    static const char types[] = "ipdipdip";
+    stkVar_t vals[8] = { { 0 } };
+    size_t n;
+
+    for(n = 4; n <= 8; n += 4)
+    {
+        stk_t *s = stkNew(128);
+        int r, i;
+        size_t k;
+
+        BENCH("stk_frame", "by_value", n, (double)ROUNDS * DEPTH, ,
+              for(r = 0; r < ROUNDS; r++) {
+                  for(i = 0; i < DEPTH; i++) {
+                      for(k = 0; k < n; k++)
+                          stkPush(s, types[k], vals[k]);
+                      for(k = 0; k < n; k++)
+                          stkPop(s);
+                  }
+              }, );
+        BENCH("stk_frame", "frame", n, (double)ROUNDS * DEPTH, ,
+              for(r = 0; r < ROUNDS; r++) {
+                  for(i = 0; i < DEPTH; i++) {
+                      stkPushFrame(s, n, types, vals);
+                      stkPopFrame(s);
+                  }
+              }, );
+        stkDestroy(s);
+    }
+}
+
+
+/** short-lived stacks, created and destroyed or got from a pool */
+static void benchLifecycle(void)
+{
+    stkPool_t *pool = stkPoolNew(128, 1 << 20);
+    stk_t *s;
+    int i, j;
+
+    BENCH("stk_lifecycle", "new_destroy", 16, DEPTH, ,
+          for(i = 0; i < DEPTH; i++) {
+              s = stkNew(128);
+              for(j = 0; j < 16; j++)
+                  stkPushInt(s, j);
+              stkDestroy(s);
+          }, );
+    BENCH("stk_lifecycle", "pool", 16, DEPTH, ,
+          for(i = 0; i < DEPTH; i++) {
+              s = stkPoolGet(pool);
+              for(j = 0; j < 16; j++)
+                  stkPushInt(s, j);
+              stkPoolPut(pool, s);
+          }, );
+    stkPoolDestroy(pool);
+}
+
+
+/** draining into an array value by value, or by borrowed spans */
+static void benchDrain(void)
+{
+    stk_t *s = stkNew(128);
+    stkSpan_t span;
+    static int out[DEPTH];
+    size_t k, j;
+    int i, n;
+
+    BENCH("stk_drain", "pop", 128, DEPTH,
+          for(i = 0; i < DEPTH; i++) stkPushInt(s, i),
+          for(n = DEPTH; stkIsInt(s); stkPop(s))
+              out[--n] = stkValInt(s), );
+    BENCH("stk_drain", "span", 128, DEPTH,
+          for(i = 0; i < DEPTH; i++) stkPushInt(s, i),
+          for(n = DEPTH; stkBorrowSpan(s, DEPTH, &span);
+              stkReleaseSpan(s, &span)) {
+              n -= span.n;
+              for(i = n, k = 0; k < span.nRuns; k++)
+                  for(j = 0; j < span.runs[k].n; j++)
+                      out[i++] = span.runs[k].els[j].var.i;
+          }, );
+    _sink = out[DEPTH-1];
+    stkDestroy(s);
+}
+
+
+/** deep fresh stacks of small fixed and of tuned block size */
+static void benchTune(void)
+{
+    stk_t *s;
+    int i, j, t;
+
+    for(t = 0; t < 2; t++)
+        BENCH("stk_tune", t ? "tuned" : "fixed", 16, (double)ROUNDS * DEPTH, ,
+              for(i = 0; i < ROUNDS; i++) {
+                  s = stkNew(16);
+                  if(t)
+                      stkTune(s, 16, 1 << 16);
+                  for(j = 0; j < DEPTH; j++)
+                      stkPushInt(s, j);
+                  stkDestroy(s);
+              }, );
+}
+
+
+/** clear and destroy of full stacks */
+static void benchClearDestroy(void)
+{
+    stk_t *s = NULL;
+    int i;
+
+    BENCH("stk_clear", "int", DEPTH, DEPTH,
+          s = stkNew(128); for(i = 0; i < DEPTH; i++) stkPushInt(s, i),
+          stkClear(s),
+          stkDestroy(s));
+    BENCH("stk_clear", "str", DEPTH, DEPTH,
+          s = stkNew(128); for(i = 0; i < DEPTH; i++) stkPushStr(s, _str[0]),
+          stkClear(s),
+          stkDestroy(s));
+    BENCH("stk_destroy", "int", DEPTH, DEPTH,
+          s = stkNew(128); for(i = 0; i < DEPTH; i++) stkPushInt(s, i),
+          stkDestroy(s), );
+    BENCH("stk_destroy", "str", DEPTH, DEPTH,
+          s = stkNew(128); for(i = 0; i < DEPTH; i++) stkPushStr(s, _str[0]),
+          stkDestroy(s), );
+}
+
+
+/** baselines: realloc'd array and nodes malloc'd one by one */
+static void benchBaselines(void)
+{
+    stkEl_t *arr = NULL;
+    size_t n, cap = 0;
+    node_t *head = NULL, *node;
+    int r, i;
+
+    BENCH("baseline", "realloc_array", 0, (double)ROUNDS * DEPTH, ,
+          for(r = 0; r < ROUNDS; r++) {
+              for(i = 0, n = 0; i < DEPTH; i++) {
+                  if(n == cap) {
+                      cap = cap ? 2*cap : 16;
+                      arr = realloc(arr, sizeof(*arr) * cap);
+                  }
+                  arr[n].type = 'i';
+                  arr[n++].var.i = i;
+              }
+              while(n)
+                  _sink += arr[--n].var.i;
+          }, );
+    free(arr);
+
+    BENCH("baseline", "malloc_node", 0, (double)ROUNDS * DEPTH, ,
+          for(r = 0; r < ROUNDS; r++) {
+              for(i = 0; i < DEPTH; i++) {
+                  node = malloc(sizeof(*node));
+                  node->el.type = 'i';
+                  node->el.var.i = i;
+                  listAdd(node, head);
+              }
+              while((node = head)) {
+                  _sink += node->el.var.i;
+                  listDel(head);
+                  free(node);
+              }
+          }, );
+}
+
+
+int main(void)
+{
+    size_t l;
+
+    for(l = 0; l < sizeof(_lens)/sizeof(_lens[0]); l++)
+        memset(_str[l], 'x', _lens[l] - 1);
+
+    benchPushPop();
+    benchStrings();
+    benchFrames();
+    benchLifecycle();
+    benchTune();
+    benchDrain();
+    benchClearDestroy();
+    benchBaselines();
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file     cache.h
+ * @brief    bounded intrusive cache with CLOCK eviction
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Entries are indexed by key in a hash table (see hash.h) and are kept on
+ * a circular list, the clock, through their own link members (see
+ * list.h). A hit only sets the reference flag of the entry. When the
+ * cache is full, the hand sweeps the clock clearing flags, and evicts the
+ * first entry found unreferenced since the hand passed it last - the one
+ * least recently used as approximated by CLOCK. New entries go just
+ * behind the hand, to be checked last. Lookup, addition and eviction are
+ * O(1) (amortized for eviction), nothing is allocated per entry. Removal
+ * by key is O(n) though, the clock being singly linked.
+ *
+ *               hand
+ *                |
+ *                v
+ *        .--> +------+     +------+     +------+
+ *        |    | ref1 |---> | ref0 |---> | ref1 |--.
+ *        |    +------+     +------+     +------+  |
+ *        |       ^ new ones go here, just before  |
+ *        '----------------------------------------'
+ *
+ * Entries of a cache need the members declared by `CACHE_LINKS()`.
+ *
+ * @param  c       cache variable, declared by `CACHE()`
+ * @param  ldif    unique link differentiator of the entries' cache links
+ *                 (optional, see list.h)
+ * @param  hashfn  hash function, see hash.h
+ * @param  cmpfn   compare function, returning zero for equal keys
+ * @param  fld     member field of entries being the key, together with
+ *                 the member access operator (->), or empty to use the
+ *                 whole struct
+ *
+ * Usage example:
+ *
+ *        struct entry_t { int key; CACHE_LINKS(struct entry_t,); ... };
+ *        CACHE(struct entry_t) c;
+ *
+ *        cacheInit(c, 1024);
+ *        if((e = cacheFind(c,, intHash, intCmp, ->key, key)) == NULL)
+ *            cacheAdd(load(key), c,, intHash, intCmp, ->key, unload);
+ *        cacheDestroy(c,, unload);
+ */
+
+
+#ifndef __CACHE_H
+#define __CACHE_H
+
+
+#include "list.h"
+#include "hash.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** name of reference flag member parameter within the entry struct */
+#define CACHE_REF_(...)  __ref_##__VA_ARGS__
+
+
+/**
+ * declares the members an entry needs to be cached: link on the clock,
+ * link in the index and reference flag
+ *
+ * @param  type  type of entry (struct)
+ * @param  ldif  unique link differentiator (optional, may be left empty)
+ */
+#define CACHE_LINKS(type, ldif)                                               \
+        type *LIST_LINK_(ldif);                                               \
+        type *LIST_LINK_(ldif##Idx);                                          \
+        unsigned char CACHE_REF_(ldif)
+
+
+/**
+ * declares a cache of entries of given type
+ *
+ * @param  type  type of entries (struct)
+ */
+#define CACHE(type)                                                           \
+        struct {                                                              \
+            HASH_TABLE(type) idx; /* index of entries by key */               \
+            type *hand;         /* entry to be checked next for eviction,     \
+                                   NULL if empty */                           \
+            type *prev;         /* entry before the hand on the clock */      \
+            unsigned long cap;  /* capacity in entries */                     \
+            unsigned long hits; /* number of lookups finding an entry */      \
+            unsigned long misses; /* number of lookups finding none */        \
+            unsigned long evictions; /* number of entries evicted */          \
+        }
+
+
+/** gets number of entries in cache */
+#define cacheSize(c) \
+        hashSize((c).idx)
+
+
+/**
+ * sets up cache allocating its index
+ *
+ * @param  c    cache variable
+ * @param  max  capacity in entries, at least 1
+ * @return      0 on success; -1 if index could not be allocated
+ */
+#define cacheInit(c, max)                                                     \
+({                                                                            \
+        (c).hand = (c).prev = NULL;                                           \
+        (c).cap = (max);                                                      \
+        (c).hits = (c).misses = (c).evictions = 0;                            \
+        hashInit((c).idx, (c).cap);                                           \
+})
+
+
+/**
+ * finds entry of given key, marking it as referenced
+ *
+ * @param  c       cache variable
+ * @param  ldif    unique link differentiator (optional)
+ * @param  hashfn  hash function, called with key
+ * @param  cmpfn   compare function, called with entry field, key and args
+ * @param  fld     member field being the key, see above
+ * @param  key     key to find, evaluated more than once
+ * @param  args    optional additional arguments to pass over to the compare
+ *                 function
+ * @return         pointer of entry, if any; NULL otherwise
+ */
+#define cacheFind(c, ldif, hashfn, cmpfn, fld, key, args...)                  \
+({                                                                            \
+        typeof((c).hand) __hit =                                              \
+            hashFind((c).idx, ldif##Idx, hashfn, cmpfn, fld, key, ##args);    \
+                                                                              \
+        if(__hit) {                                                           \
+            __hit->CACHE_REF_(ldif) = 1;                                      \
+            (c).hits++;                                                       \
+        } else                                                                \
+            (c).misses++;                                                     \
+        __hit;                                                                \
+})
+
+
+/**
+ * evicts an entry by CLOCK: sweeps the hand over referenced entries,
+ * clearing their flags, up to an unreferenced one
+ *
+ * @note  called by `cacheAdd()`, not to be called directly
+ */
+#define _cacheEvict(c, ldif, hashfn, cmpfn, fld, evictfn, args...)            \
+({                                                                            \
+        typeof((c).hand) __v;                                                 \
+                                                                              \
+        while((c).hand->CACHE_REF_(ldif)) {                                   \
+            (c).hand->CACHE_REF_(ldif) = 0;                                   \
+            (c).prev = (c).hand;                                              \
+            listStep((c).hand, ldif);                                         \
+        }                                                                     \
+        __v = (c).hand;                                                       \
+        if(__v == (c).prev)                                                   \
+            (c).hand = (c).prev = NULL;                                       \
+        else                                                                  \
+            (c).hand = (c).prev->LIST_LINK_(ldif) = __v->LIST_LINK_(ldif);    \
+        hashDel((c).idx, ldif##Idx, hashfn, cmpfn, fld, __v fld, ##args);     \
+        (c).evictions++;                                                      \
+        evictfn(__v);                                                         \
+})
+
+
+/**
+ * adds new entry to cache if an entry of the same key is not yet present,
+ * evicting one if cache is full
+ *
+ * @param  new      pointer to the new entry that is to be added (struct *)
+ * @param  c        cache variable
+ * @param  ldif     unique link differentiator (optional)
+ * @param  hashfn   hash function, called with entry field
+ * @param  cmpfn    compare function, called with fields of both entries and
+ *                  args
+ * @param  fld      member field being the key, see above
+ * @param  evictfn  function called with each evicted entry, e.g., to free it
+ * @param  args     optional additional arguments to pass over to the
+ *                  compare function
+ * @return          true if entry is added; false if an entry of the same
+ *                  key is already present
+ */
+#define cacheAdd(new, c, ldif, hashfn, cmpfn, fld, evictfn, args...)          \
+({                                                                            \
+        typeof(new) __add = (new);                                            \
+        int __added = 0;                                                      \
+                                                                              \
+        if(hashFind((c).idx, ldif##Idx, hashfn, cmpfn, fld, __add fld,        \
+                    ##args) == NULL) {                                        \
+            if(cacheSize(c) >= (c).cap)                                       \
+                _cacheEvict(c, ldif, hashfn, cmpfn, fld, evictfn, ##args);    \
+            hashAdd(__add, (c).idx, ldif##Idx, hashfn, fld);                  \
+            __add->CACHE_REF_(ldif) = 0;                                      \
+            /* just behind the hand */                                        \
+            if((c).hand) {                                                    \
+                __add->LIST_LINK_(ldif) = (c).hand;                           \
+                (c).prev->LIST_LINK_(ldif) = __add;                           \
+                (c).prev = __add;                                             \
+            } else                                                            \
+                (c).hand = (c).prev = __add->LIST_LINK_(ldif) = __add;        \
+            __added = 1;                                                      \
+        }                                                                     \
+        __added;                                                              \
+})
+
+
+/**
+ * removes entry of given key from cache, without calling evict function
+ *
+ * @param  c       cache variable
+ * @param  ldif    unique link differentiator (optional)
+ * @param  hashfn  hash function, called with key
+ * @param  cmpfn   compare function, called with entry field, key and args
+ * @param  fld     member field being the key, see above
+ * @param  key     key of entry to remove, evaluated more than once
+ * @param  args    optional additional arguments to pass over to the compare
+ *                 function
+ * @return         pointer of removed entry, if any; NULL otherwise
+ * @note           O(n), as the clock is walked for the entry before it;
+ *                 meant for invalidation, not for regular use
+ */
+#define cacheDel(c, ldif, hashfn, cmpfn, fld, key, args...)                   \
+({                                                                            \
+        typeof((c).hand) __del =                                              \
+            hashDel((c).idx, ldif##Idx, hashfn, cmpfn, fld, key, ##args);     \
+        typeof((c).hand) __p;                                                 \
+                                                                              \
+        if(__del && __del->LIST_LINK_(ldif) == __del)                         \
+            (c).hand = (c).prev = NULL;                                       \
+        else if(__del) {                                                      \
+            for(__p = __del; __p->LIST_LINK_(ldif) != __del; )                \
+                listStep(__p, ldif);                                          \
+            __p->LIST_LINK_(ldif) = __del->LIST_LINK_(ldif);                  \
+            if((c).hand == __del)                                             \
+                (c).hand = __del->LIST_LINK_(ldif);                           \
+            if((c).prev == __del)                                             \
+                (c).prev = __p;                                               \
+        }                                                                     \
+        __del;                                                                \
+})
+
+
+/**
+ * destroys cache, calling evict function with each entry
+ *
+ * @param  c        cache variable
+ * @param  ldif     unique link differentiator (optional)
+ * @param  evictfn  function called with each entry, see `cacheAdd()`
+ */
+#define cacheDestroy(c, ldif, evictfn)                                        \
+({                                                                            \
+        typeof((c).hand) __e, __next;                                         \
+                                                                              \
+        if((c).prev) {                                                        \
+            (c).prev->LIST_LINK_(ldif) = NULL;                                \
+            for(__e = (c).hand; __e; __e = __next) {                          \
+                __next = __e->LIST_LINK_(ldif);                               \
+                evictfn(__e);                                                 \
+            }                                                                 \
+        }                                                                     \
+        (c).hand = (c).prev = NULL;                                           \
+        hashDestroy((c).idx);                                                 \
+})
+
+
+#endif /* __CACHE_H */
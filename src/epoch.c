@@ -0,0 +1,208 @@
+/**
+ * @file     epoch.c
+ * @brief    epoch-based reclamation for read-mostly lock-free lists
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "epoch.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** compares pointers for list searches */
+#define PTRCMP(a, b)  ((a) != (b))
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct epochObj_t epochObj_t;
+struct epochObj_t
+{
+    void *ptr;                  /* object retired */
+    void (*freefn)(void *);     /* function freeing it */
+    unsigned long epoch;        /* global epoch it was retired in */
+    epochObj_t *LIST_LINK;      /* link to the one retired before */
+
+}; /* retired object */
+
+
+struct epoch_t
+{
+    unsigned long epoch;        /* global epoch, from 1 (atomic) */
+    epochThr_t *thrs;           /* list of thread records */
+    epochObj_t *retired;        /* list of retired objects, newest first */
+    size_t nRetired;            /* number of retired objects */
+    pthread_mutex_t lock;       /* lock of all above, but epoch for reads */
+
+}; /* reclamation domain */
+
+
+/* ----- function definitions ---------------------------------------------- */
+
+
+/** advances global epoch if every thread reading has seen it; locked */
+static void
+advance(epoch_t *dom)
+{
+    unsigned long g = dom->epoch, e;
+    epochThr_t *thr;
+
+    /* pairs with the fence of readers announcing their epoch */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    listForEach(thr, dom->thrs)
+        if((e = __atomic_load_n(&thr->epoch, __ATOMIC_ACQUIRE)) && e != g)
+            return;
+    __atomic_store_n(&dom->epoch, g + 1, __ATOMIC_SEQ_CST);
+} /* advance */
+
+
+/** frees a list of retired objects */
+static size_t
+objFreeAll(epochObj_t *objs)
+{
+    epochObj_t *obj, *tmpObj;
+    size_t n = 0;
+
+    listForEachSafe(obj, tmpObj, objs)
+    {
+        obj->freefn(obj->ptr);
+        free(obj);
+        n++;
+    }
+    return n;
+} /* objFreeAll */
+
+
+epoch_t *
+epochNew(void)
+{
+    epoch_t *dom;
+
+    if((dom = calloc(1, sizeof(*dom))) == NULL)
+        return NULL;
+    pthread_mutex_init(&dom->lock, NULL);
+    dom->epoch = 1;
+    return dom;
+} /* epochNew */
+
+
+epochThr_t *
+epochRegister(epoch_t *dom)
+{
+    epochThr_t *thr;
+
+    /* a cache line of its own, written by its thread only */
+    if((thr = aligned_alloc(EPOCH_LINE, sizeof(*thr))) == NULL)
+        return NULL;
+    memset(thr, 0, sizeof(*thr));
+    thr->global = &dom->epoch;
+    thr->dom = dom;
+
+    pthread_mutex_lock(&dom->lock);
+    listAdd(thr, dom->thrs);
+    pthread_mutex_unlock(&dom->lock);
+    return thr;
+} /* epochRegister */
+
+
+void
+epochUnregister(epochThr_t *thr)
+{
+    epoch_t *dom = thr->dom;
+
+    pthread_mutex_lock(&dom->lock);
+    listDelMatch(dom->thrs,, PTRCMP, , thr);
+    pthread_mutex_unlock(&dom->lock);
+    free(thr);
+} /* epochUnregister */
+
+
+void
+epochRetire(epoch_t *dom, void *ptr, void (*freefn)(void *))
+{
+    epochObj_t *obj;
+    size_t n;
+
+    if((obj = malloc(sizeof(*obj))) == NULL)
+    {
+        epochSync(dom);
+        freefn(ptr);
+        return;
+    }
+    obj->ptr = ptr;
+    obj->freefn = freefn;
+
+    /* unlinked before the epoch it is retired in is read */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&dom->lock);
+    obj->epoch = dom->epoch;
+    listAdd(obj, dom->retired);
+    n = ++dom->nRetired;
+    pthread_mutex_unlock(&dom->lock);
+
+    if(n % EPOCH_BATCH == 0)
+        epochReclaim(dom);
+} /* epochRetire */
+
+
+size_t
+epochReclaim(epoch_t *dom)
+{
+    epochObj_t **link, *objs = NULL, *obj;
+
+    pthread_mutex_lock(&dom->lock);
+    advance(dom);
+
+    /* newest first, so the ones to free are a tail of the list */
+    listForEachLink(link, &dom->retired)
+        if((*link)->epoch + 2 <= dom->epoch)
+        {
+            objs = *link;
+            *link = NULL;
+            break;
+        }
+    listForEach(obj, objs)
+        dom->nRetired--;
+    pthread_mutex_unlock(&dom->lock);
+
+    return objFreeAll(objs);
+} /* epochReclaim */
+
+
+void
+epochSync(epoch_t *dom)
+{
+    unsigned long g;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    g = __atomic_load_n(&dom->epoch, __ATOMIC_SEQ_CST) + 2;
+
+    /* the reclaim reaching g frees all retired up to the call */
+    for(epochReclaim(dom);
+        __atomic_load_n(&dom->epoch, __ATOMIC_ACQUIRE) < g;
+        epochReclaim(dom))
+        sched_yield();
+} /* epochSync */
+
+
+void
+epochDestroy(epoch_t *dom)
+{
+    epochThr_t *thr, *tmpThr;
+
+    objFreeAll(dom->retired);
+    listForEachSafe(thr, tmpThr, dom->thrs)
+        free(thr);
+    pthread_mutex_destroy(&dom->lock);
+    free(dom);
+} /* epochDestroy */
@@ -0,0 +1,207 @@
+/**
+ * @file     epoch.h
+ * @brief    epoch-based reclamation for read-mostly lock-free lists
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Readers of lists changed by the RCU style macros of list.h mark their
+ * traversals as read sections, announcing the global epoch they started
+ * in. Writers retire the entries they unlink instead of freeing them.
+ * The global epoch advances once every thread in a read section has seen
+ * the current one, and an entry retired in an epoch is freed two epochs
+ * later, when no reader can be on it any more. Readers only write their
+ * own record, a cache line of their own, so read sections take no lock
+ * and bounce no cache line between threads.
+ *
+ * Usage example:
+ *
+ *        epoch_t *dom = epochNew();
+ *
+ *        (reader thread)
+ *        epochThr_t *thr = epochRegister(dom);
+ *        epochEnter(thr);
+ *        route = listFindRcu(routes,, strcmp, ->dest, dest);
+ *        ...
+ *        epochLeave(thr);
+ *        epochUnregister(thr);
+ *
+ *        (writer, holding the writers' lock)
+ *        if((old = listReplaceRcu(route, routes,, strcmp, ->dest, dest)))
+ *            epochRetire(dom, old, free);
+ *
+ *        epochDestroy(dom);
+ */
+
+
+#ifndef __EPOCH_H
+#define __EPOCH_H
+
+
+#include <stddef.h>
+
+#include "list.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/* if not GNU C, elide __attribute__ */
+#ifndef __GNUC__
+#  define __attribute__(x) /* nothing */
+#endif
+
+
+/** size of cache line each thread record is aligned to */
+#define EPOCH_LINE       64
+
+/** number of entries retired before reclaiming is attempted */
+#define EPOCH_BATCH      64
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct epoch_t epoch_t; /* reclamation domain, opaque */
+
+
+typedef struct epochThr_t
+{
+    unsigned long epoch;        /* epoch announced, 0 if not reading */
+    unsigned long nest;         /* depth of nested read sections */
+
+    /* members for administrative use only */
+
+    const unsigned long *global; /* global epoch of domain */
+    epoch_t *dom;               /* domain registered to */
+    struct epochThr_t *LIST_LINK; /* link to next thread of domain */
+
+} __attribute__((aligned(EPOCH_LINE))) epochThr_t; /* thread record */
+
+
+/* ----- function signatures ----------------------------------------------- */
+
+
+/**
+ * creates a new reclamation domain
+ *
+ * @return  new domain on success; NULL otherwise
+ */
+epoch_t *
+epochNew(void)
+    __attribute__((malloc, warn_unused_result));
+
+
+/**
+ * registers calling thread as a reader of domain
+ *
+ * @return  thread record on success, to be used by that thread only;
+ *          NULL otherwise
+ */
+epochThr_t *
+epochRegister(epoch_t *dom)
+    __attribute__((nonnull(1), warn_unused_result));
+
+
+/**
+ * unregisters a thread, outside read sections
+ */
+void
+epochUnregister(epochThr_t *thr)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * retires an object unlinked from lists read by the domain's readers, to
+ * be freed once no reader can be on it
+ *
+ * @param  dom     domain
+ * @param  ptr     object unlinked
+ * @param  freefn  function freeing object
+ * @note           may free retired objects; if no memory is left to keep
+ *                 track of the object, waits for readers by `epochSync()`
+ *                 and frees it at once, so not to be called within a read
+ *                 section
+ */
+void
+epochRetire(epoch_t *dom, void *ptr, void (*freefn)(void *))
+    __attribute__((nonnull(1, 3)));
+
+
+/**
+ * advances the global epoch if every reader has seen it, and frees
+ * objects retired at least two epochs before
+ *
+ * @return  number of objects freed
+ */
+size_t
+epochReclaim(epoch_t *dom)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * waits until every object retired so far is freed, i.e., until readers
+ * in read sections at the call have left them; not to be called within a
+ * read section
+ */
+void
+epochSync(epoch_t *dom)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * destroys domain, freeing every object retired and every thread record;
+ * no thread may be in a read section
+ */
+void
+epochDestroy(epoch_t *dom)
+    __attribute__((nonnull(1)));
+
+
+/* ----- inline functions -------------------------------------------------- */
+
+
+/**
+ * enters a read section, during which entries seen on lists are not
+ * freed; may be nested
+ *
+ * @param  thr  record of calling thread
+ */
+static inline void
+epochEnter(epochThr_t *thr)
+{
+    if(thr->nest++ == 0)
+    {
+        __atomic_store_n(&thr->epoch,
+                         __atomic_load_n(thr->global, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+        /* announced before any list is read */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+} /* epochEnter */
+
+
+/**
+ * leaves a read section; entries seen within must not be used any more
+ *
+ * @param  thr  record of calling thread
+ */
+static inline void
+epochLeave(epochThr_t *thr)
+{
+    if(--thr->nest == 0)
+        __atomic_store_n(&thr->epoch, 0, __ATOMIC_RELEASE);
+} /* epochLeave */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __EPOCH_H */
@@ -0,0 +1,299 @@
+/**
+ * @file     hash.h
+ * @brief    intrusive hash table on singly linked list chains
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Entries are chained into buckets through their own link members (see
+ * list.h), so nothing is allocated per entry; only the bucket array is
+ * allocated. The number of buckets is a power of two and it is doubled
+ * when entries outnumber buckets. Doubling is incremental: the old array
+ * is kept next to the new one, and every later addition or deletion moves
+ * a few old buckets over, so no single operation rehashes the whole
+ * table. Lookups check the old bucket while it is not moved yet.
+ *
+ *        tbl
+ *        +------+      +---+---+---+---+---+---+---+---+
+ *        | bkts |----> |   | o |   | o |   |   | o |   |
+ *        | old  |--.   +---+-|-+---+-|-+---+---+-|-+---+
+ *        | ...  |  |         v       v           v
+ *        +------+  |       entry   entry       entry --> entry
+ *                  |   +---+---+---+---+
+ *                  '-> | - | - | o |   |  <- moved up to here
+ *                      +---+---+-|-+---+
+ *                                v
+ *                              entry
+ *
+ * @param  tbl     hash table variable, declared by `HASH_TABLE()`
+ * @param  ldif    unique link differentiator of entries' link used for
+ *                 chaining (optional, see list.h)
+ * @param  hashfn  hash function, taking a key (entry field) and returning
+ *                 an unsigned integer; equal keys must have equal hashes
+ * @param  cmpfn   compare function, returning zero for equal keys
+ * @param  fld     member field of entries being the key, together with
+ *                 the member access operator (->), or empty to use the
+ *                 whole struct
+ *
+ * Usage example:
+ *
+ *        HASH_TABLE(entry_t) tbl = HASH_TABLE_INIT;
+ *
+ *        hashInit(tbl, 64);
+ *        hashAddQ(entry, tbl,, strHash, strcmp, ->name);
+ *        found = hashFind(tbl,, strHash, strcmp, ->name, "key");
+ *        hashDestroy(tbl);
+ */
+
+
+#ifndef __HASH_H
+#define __HASH_H
+
+
+#include <stdlib.h>
+
+#include "list.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of old buckets moved over by each addition and deletion while
+ *  the table is being doubled; enough to finish before the next doubling */
+#define HASH_MIGRATE     2
+
+
+/**
+ * declares a hash table of entries of given type
+ *
+ * @param  type  type of entries (struct)
+ */
+#define HASH_TABLE(type)                                                      \
+        struct {                                                              \
+            type **bkts;        /* buckets, heads of chains */                \
+            type **old;         /* buckets before doubling, NULL if none */   \
+            unsigned long nBkts; /* number of buckets */                      \
+            unsigned long nOld; /* number of buckets before doubling */       \
+            unsigned long moved; /* number of old buckets moved over */       \
+            unsigned long n;    /* number of entries */                       \
+        }
+
+
+/** initializer of an empty hash table, to be set up by `hashInit()` */
+#define HASH_TABLE_INIT  { NULL, NULL, 0, 0, 0, 0 }
+
+
+/** gets number of entries in hash table */
+#define hashSize(tbl) \
+        ((tbl).n)
+
+
+/**
+ * sets up hash table allocating its buckets
+ *
+ * @param  tbl   hash table variable
+ * @param  size  initial number of buckets, rounded up to a power of two
+ * @return       0 on success; -1 if buckets could not be allocated
+ */
+#define hashInit(tbl, size)                                                   \
+({                                                                            \
+        unsigned long __n = 1;                                                \
+                                                                              \
+        while(__n < (unsigned long)(size))                                    \
+            __n *= 2;                                                         \
+        (tbl).old = NULL;                                                     \
+        (tbl).nOld = (tbl).moved = (tbl).n = 0;                               \
+        (tbl).nBkts = __n;                                                    \
+        ((tbl).bkts = calloc(__n, sizeof(*(tbl).bkts))) ? 0 : -1;             \
+})
+
+
+/**
+ * frees buckets of hash table; entries are left to their owner
+ *
+ * @param  tbl  hash table variable
+ */
+#define hashDestroy(tbl)                                                      \
+({                                                                            \
+        free((tbl).bkts);                                                     \
+        free((tbl).old);                                                      \
+        (tbl).bkts = (tbl).old = NULL;                                        \
+        (tbl).nBkts = (tbl).nOld = (tbl).moved = (tbl).n = 0;                 \
+})
+
+
+/**
+ * gets bucket (head variable of chain) of a hash value
+ *
+ * @param  tbl  hash table variable
+ * @param  h    hash value, a variable as it is evaluated more than once
+ */
+#define hashBkt(tbl, h)                                                       \
+        (*((tbl).old && ((h) & ((tbl).nOld - 1)) >= (tbl).moved ?             \
+           &(tbl).old[(h) & ((tbl).nOld - 1)] :                               \
+           &(tbl).bkts[(h) & ((tbl).nBkts - 1)]))
+
+
+/**
+ * iterates over entries of hash table, in no particular order
+ *
+ * @param  pos   loop cursor variable (struct *)
+ * @param  i     bucket index variable (unsigned long)
+ * @param  tbl   hash table variable; must not be modified meanwhile
+ * @param  ...   unique link differentiator (optional)
+ * @note         consists of two nested loops, `break` leaves only the
+ *               inner one
+ */
+#define hashForEach(pos, i, tbl, ...)                                         \
+        for(i = 0; i < (tbl).nOld + (tbl).nBkts; i++)                         \
+            listForEach(pos, i < (tbl).nOld ? (tbl).old[i] :                  \
+                             (tbl).bkts[i - (tbl).nOld], __VA_ARGS__)
+
+
+/**
+ * moves a few old buckets over while hash table is being doubled, then
+ * starts doubling if entries outnumber buckets
+ *
+ * @note  called by the modifying macros, not to be called directly
+ */
+#define _hashStep(tbl, ldif, hashfn, fld)                                     \
+({                                                                            \
+        typeof((tbl).bkts[0]) __e;                                            \
+        typeof((tbl).bkts) __nb;                                              \
+        unsigned long __m;                                                    \
+                                                                              \
+        for(__m = 0; (tbl).old && __m < HASH_MIGRATE; __m++) {                \
+            while((__e = (tbl).old[(tbl).moved])) {                           \
+                listDel((tbl).old[(tbl).moved], ldif);                        \
+                listAdd(__e, (tbl).bkts[hashfn(__e fld) &                     \
+                                        ((tbl).nBkts - 1)], ldif);            \
+            }                                                                 \
+            if(++(tbl).moved == (tbl).nOld) {                                 \
+                free((tbl).old);                                              \
+                (tbl).old = NULL;                                             \
+                (tbl).nOld = (tbl).moved = 0;                                 \
+            }                                                                 \
+        }                                                                     \
+        /* stays as it is if the bigger array cannot be allocated */          \
+        if((tbl).old == NULL && (tbl).n >= (tbl).nBkts &&                     \
+           (__nb = calloc(2 * (tbl).nBkts, sizeof(*(tbl).bkts)))) {           \
+            (tbl).old = (tbl).bkts;                                           \
+            (tbl).nOld = (tbl).nBkts;                                         \
+            (tbl).bkts = __nb;                                                \
+            (tbl).nBkts *= 2;                                                 \
+        }                                                                     \
+})
+
+
+/**
+ * finds entry of given key
+ *
+ * @param  tbl     hash table variable
+ * @param  ldif    unique link differentiator (optional)
+ * @param  hashfn  hash function, called with key
+ * @param  cmpfn   compare function, called with entry field, key and args
+ * @param  fld     member field being the key, see above
+ * @param  key     key to find, evaluated more than once
+ * @param  args    optional additional arguments to pass over to the compare
+ *                 function
+ * @return         pointer of entry, if any; NULL otherwise
+ * @note           O(1) on average, does not modify the table
+ */
+#define hashFind(tbl, ldif, hashfn, cmpfn, fld, key, args...)                 \
+({                                                                            \
+        unsigned long __h = hashfn(key);                                      \
+                                                                              \
+        listFind(hashBkt(tbl, __h), ldif, cmpfn, fld, key, ##args);           \
+})
+
+
+/**
+ * adds new entry to hash table, without checking for its key
+ *
+ * @param  new     pointer to the new entry that is to be added (struct *)
+ * @param  tbl     hash table variable
+ * @param  ldif    unique link differentiator (optional)
+ * @param  hashfn  hash function, called with entry field
+ * @param  fld     member field being the key, see above
+ * @return         new
+ */
+#define hashAdd(new, tbl, ldif, hashfn, fld)                                  \
+({                                                                            \
+        typeof(new) __ent = (new);                                            \
+        unsigned long __h;                                                    \
+                                                                              \
+        _hashStep(tbl, ldif, hashfn, fld);                                    \
+        __h = hashfn(__ent fld);                                              \
+        listAdd(__ent, hashBkt(tbl, __h), ldif);                              \
+        (tbl).n++;                                                            \
+        __ent;                                                                \
+})
+
+
+/**
+ * adds new entry to hash table if an entry of the same key is not yet
+ * present
+ *
+ * @param  new     pointer to the new entry that is to be added (struct *)
+ * @param  tbl     hash table variable
+ * @param  ldif    unique link differentiator (optional)
+ * @param  hashfn  hash function, called with entry field
+ * @param  cmpfn   compare function, called with fields of both entries and
+ *                 args
+ * @param  fld     member field being the key, see above
+ * @param  args    optional additional arguments to pass over to the compare
+ *                 function
+ * @return         true if entry is added; false if an entry of the same key
+ *                 is already present
+ */
+#define hashAddQ(new, tbl, ldif, hashfn, cmpfn, fld, args...)                 \
+({                                                                            \
+        typeof(new) __ent = (new);                                            \
+        unsigned long __h;                                                    \
+        int __added = 0;                                                      \
+                                                                              \
+        _hashStep(tbl, ldif, hashfn, fld);                                    \
+        __h = hashfn(__ent fld);                                              \
+        if(listFind(hashBkt(tbl, __h), ldif, cmpfn, fld, __ent fld,           \
+                    ##args) == NULL) {                                        \
+            listAdd(__ent, hashBkt(tbl, __h), ldif);                          \
+            (tbl).n++;                                                        \
+            __added = 1;                                                      \
+        }                                                                     \
+        __added;                                                              \
+})
+
+
+/**
+ * removes entry of given key from hash table
+ *
+ * @param  tbl     hash table variable
+ * @param  ldif    unique link differentiator (optional)
+ * @param  hashfn  hash function, called with key
+ * @param  cmpfn   compare function, called with entry field, key and args
+ * @param  fld     member field being the key, see above
+ * @param  key     key of entry to remove, evaluated more than once
+ * @param  args    optional additional arguments to pass over to the compare
+ *                 function
+ * @return         pointer of removed entry, if any; NULL otherwise
+ */
+#define hashDel(tbl, ldif, hashfn, cmpfn, fld, key, args...)                  \
+({                                                                            \
+        typeof((tbl).bkts) __i;                                               \
+        typeof((tbl).bkts[0]) __entry = NULL;                                 \
+        unsigned long __h;                                                    \
+                                                                              \
+        _hashStep(tbl, ldif, hashfn, fld);                                    \
+        __h = hashfn(key);                                                    \
+        listForEachLink(__i, &hashBkt(tbl, __h), ldif)                        \
+            if(cmpfn((*__i) fld, key, ##args) == 0) {                         \
+                __entry = *__i;                                               \
+                listDel(*__i, ldif);                                          \
+                (tbl).n--;                                                    \
+                break;                                                        \
+            }                                                                 \
+        __entry;                                                              \
+})
+
+
+#endif /* __HASH_H */
@@ -0,0 +1,283 @@
+/**
+ * @file     ilist.h
+ * @brief    singly linked list of entries of one array, linked by indices
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * The same list as of list.h, but for entries being elements of a single
+ * array (a base): links and heads are 32-bit indices into the base instead
+ * of pointers, `ILIST_NIL` ending the list. On 64-bit hosts this halves
+ * the memory of links, and since no address is stored, the base with the
+ * lists in it can be moved, written to a file, or mapped to different
+ * addresses by processes sharing it. Up to `ILIST_NIL` entries per base.
+ *
+ *                                    head: 3
+ *                                         |
+ *                                         v
+ *        base  +------+------+------+------+------+
+ *              | fld  | fld  | fld  | fld  | fld  |
+ *              | 4    | NIL  | ...  | 0    | 1    |  <- LINK
+ *              +------+------+------+------+------+
+ *                 0      1      2      3      4
+ *
+ *        list: 3 -> 0 -> 4 -> 1 -> NIL
+ *
+ * @param  base   pointer to the first element of the array (struct *)
+ *                entries of the list are in; evaluated several times, so
+ *                not to have side effects
+ * @param  head   index of the first entry on the list (uint32_t); must be
+ *                set to `ILIST_NIL` before the first operation on the list
+ * @param  LINK   index member of the entry struct to implement linking,
+ *                declared as `uint32_t ILIST_LINK;` or, for entries linked
+ *                to more than one lists, as `uint32_t ILIST_LINK_(ldif);`
+ *                (see list.h)
+ * @param  fld    payload member fields of the entry struct
+ * @param  pos    a pointer to any entry on the list
+ *
+ * Usage example:
+ *
+ *        struct node_t { int key; uint32_t ILIST_LINK; } *nodes = ...;
+ *        uint32_t head = ILIST_NIL;
+ *
+ *        ilistAdd(&nodes[i], nodes, head);
+ *        node = ilistFind(nodes, head,, NUMCMP, ->key, 42);
+ */
+
+
+#ifndef __ILIST_H
+#define __ILIST_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** index ending a list, the head of an empty one */
+#define ILIST_NIL        UINT32_MAX
+
+
+/** name of index link member within the entry struct */
+#define ILIST_LINK       ILIST_LINK_()
+
+
+/** name of index link member with a differentiator, see `LIST_LINK_()` */
+#define ILIST_LINK_(...) __inext_##__VA_ARGS__
+
+
+/**
+ * gets index of an entry
+ *
+ * @param  base  base of entries (struct *)
+ * @param  pos   pointer to the entry (struct *)
+ */
+#define ilistIdx(base, pos) \
+        ((uint32_t)((pos) - (base)))
+
+
+/**
+ * gets entry at index
+ *
+ * @param  base  base of entries (struct *)
+ * @param  idx   index of the entry, or `ILIST_NIL`
+ * @return       pointer to the entry; NULL if idx is `ILIST_NIL`
+ */
+#define ilistAt(base, idx) \
+        ((idx) == ILIST_NIL ? NULL : &(base)[idx])
+
+
+/**
+ * gets next list entry after the one at current position
+ *
+ * @param  base  base of entries (struct *)
+ * @param  pos   pointer to the list entry (struct *) next of which is got
+ * @param  ...   unique link differentiator (optional)
+ * @return       pointer to next entry; NULL if pos is the last
+ */
+#define ilistNext(base, pos, ...) \
+        ilistAt(base, (pos)->ILIST_LINK_(__VA_ARGS__))
+
+
+/**
+ * iterates over a list
+ *
+ * @param  pos   loop cursor variable (struct *)
+ * @param  base  base of entries (struct *)
+ * @param  head  list head, index of first entry
+ * @param  ...   unique link differentiator (optional)
+ */
+#define ilistForEach(pos, base, head, ...)                                    \
+        for(pos = ilistAt(base, head); pos != NULL;                           \
+            pos = ilistNext(base, pos, __VA_ARGS__))
+
+
+/**
+ * iterates over the addresses of links in a list
+ *
+ * @param  posP  loop cursor variable (uint32_t *), on each iteration being
+ *               set to the address of the preceding entry's link member,
+ *               or to the head in case of the very first entry
+ * @param  base  base of entries (struct *)
+ * @param  headP pointer to the list head variable (uint32_t *)
+ * @param  ...   unique link differentiator (optional)
+ */
+#define ilistForEachLink(posP, base, headP, ...)                              \
+        for(posP = headP; *posP != ILIST_NIL;                                 \
+            posP = &(base)[*posP].ILIST_LINK_(__VA_ARGS__))
+
+
+/**
+ * inserts new entry to list head
+ *
+ * @param  new   pointer to the new entry that is to be added (struct *),
+ *               an element of base
+ * @param  base  base of entries (struct *)
+ * @param  head  the head variable (uint32_t) to add entry to list of;
+ *               since entry becomes the first one, head is modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       head
+ */
+#define ilistAdd(new, base, head, ...)                                        \
+({                                                                            \
+        typeof(&(base)[0]) __inew = (new);                                    \
+                                                                              \
+        __inew->ILIST_LINK_(__VA_ARGS__) = head;                              \
+        head = ilistIdx(base, __inew);                                        \
+})
+
+
+/**
+ * removes entry at head (if list is not empty)
+ *
+ * @param  base  base of entries (struct *)
+ * @param  head  the head variable (uint32_t) to remove entry from list of;
+ *               since the first entry is removed, head is modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       head
+ * @warning      removed element's link keeps it original value
+ */
+#define ilistDel(base, head, ...)                                             \
+        (head = (head) != ILIST_NIL ?                                         \
+                (base)[head].ILIST_LINK_(__VA_ARGS__) : (head))
+
+
+/**
+ * moves entry from one head to another (if source list is not empty)
+ *
+ * @param  base   base of entries of both lists (struct *)
+ * @param  headT  the target head variable (uint32_t) to add entry to list
+ *                of; to be modified
+ * @param  headS  the source head variable (uint32_t) to remove entry from
+ *                list of; to be modified
+ * @param  ...    unique link differentiator for both lists (optional)
+ * @return        headS
+ */
+#define ilistMove(base, headT, headS, ...)                                    \
+({                                                                            \
+        if((headS) != ILIST_NIL) {                                            \
+            uint32_t __itmp = (base)[headS].ILIST_LINK_(__VA_ARGS__);         \
+            (base)[headS].ILIST_LINK_(__VA_ARGS__) = headT;                   \
+            headT = headS;                                                    \
+            headS = __itmp;                                                   \
+        }                                                                     \
+        headS;                                                                \
+})
+
+
+/**
+ * reverses a list at head
+ *
+ * @param  base  base of entries (struct *)
+ * @param  head  the head variable (uint32_t) to reverse entries on list of
+ * @param  ...   unique link differentiator (optional)
+ * @return       head
+ */
+#define ilistReverse(base, head, ...)                                         \
+({                                                                            \
+        uint32_t __irev = ILIST_NIL;                                          \
+                                                                              \
+        while(ilistMove(base, __irev, head, __VA_ARGS__) != ILIST_NIL)        \
+            ;                                                                 \
+        head = __irev;                                                        \
+})
+
+
+/**
+ * finds first matching list entry
+ *
+ * @param  base   base of entries (struct *)
+ * @param  head   list head, index of first entry
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listFind()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listFind()`
+ * @return        pointer of first true entry, if any; NULL otherwise
+ */
+#define ilistFind(base, head, ldif, cmpfn, fld, args...)                      \
+({                                                                            \
+        typeof(&(base)[0]) __i;                                               \
+                                                                              \
+        ilistForEach(__i, base, head, ldif)                                   \
+            if(cmpfn(__i fld, args) == 0)                                     \
+                break;                                                        \
+        __i;                                                                  \
+})
+
+
+/**
+ * finds first matching list entry, then moves it to the list head
+ *
+ * @param  base   base of entries (struct *)
+ * @param  head   the head variable (uint32_t) of list; may be modified
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listFind()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listFind()`
+ * @return        pointer of entry found, if any; NULL otherwise
+ */
+#define ilistFindCache(base, head, ldif, cmpfn, fld, args...)                 \
+({                                                                            \
+        uint32_t *__i;                                                        \
+        typeof(&(base)[0]) __entry = NULL;                                    \
+                                                                              \
+        ilistForEachLink(__i, base, &(head), ldif)                            \
+            if(cmpfn((&(base)[*__i]) fld, args) == 0) {                       \
+                __entry = &(base)[*__i];                                      \
+                ilistDel(base, *__i, ldif);                                   \
+                ilistAdd(__entry, base, head, ldif);                          \
+                break;                                                        \
+            }                                                                 \
+        __entry;                                                              \
+})
+
+
+/**
+ * deletes each matching list entry
+ *
+ * @param  base   base of entries (struct *)
+ * @param  head   the head variable (uint32_t) to delete entries from list
+ *                of; may be modified
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listDelMatch()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listDelMatch()`
+ * @return        void
+ */
+#define ilistDelMatch(base, head, ldif, cmpfn, fld, args...)                  \
+({                                                                            \
+        uint32_t *__i = &(head);                                              \
+                                                                              \
+        while(*__i != ILIST_NIL)                                              \
+            if(cmpfn((&(base)[*__i]) fld, args) == 0)                         \
+                ilistDel(base, *__i, ldif);                                   \
+            else                                                              \
+                __i = &(base)[*__i].ILIST_LINK_(ldif);                        \
+})
+
+#endif /* __ILIST_H */
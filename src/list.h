@@ -145,6 +145,7 @@
  *               may be modified
  * @param  ...   unique link differentiator (optional)
  * @return       new
+ * @note         walks the whole list; see `listDescAddTail()` for O(1)
  */
 #define listAddTail(new, head, ...)                                           \
 ({                                                                            \
@@ -241,6 +242,195 @@
 })
 
 
+/**
+ * inserts new entry to list head atomically (compare-and-swap), so any
+ * number of threads can add to the same list at once without a lock
+ *
+ * @param  new   pointer to the new entry that is to be added (struct *)
+ * @param  head  the head variable (struct *) shared by threads; modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       new
+ * @note         entries may only be removed concurrently by
+ *               `listTakeAll()`, which takes them all at once, so a head
+ *               seen by the swap cannot be reused in between (no ABA)
+ */
+#define listAddAtomic(new, head, ...)                                         \
+({                                                                            \
+        typeof(new) __new = (new);                                            \
+                                                                              \
+        __new->LIST_LINK_(__VA_ARGS__) =                                      \
+            __atomic_load_n(&(head), __ATOMIC_RELAXED);                       \
+        while(!__atomic_compare_exchange_n(&(head),                           \
+                                           &__new->LIST_LINK_(__VA_ARGS__),   \
+                                           __new, 1, __ATOMIC_RELEASE,        \
+                                           __ATOMIC_RELAXED))                 \
+            ;                                                                 \
+        __new;                                                                \
+})
+
+
+/**
+ * takes all entries off a list atomically, leaving it empty; to be used by
+ * a single consumer of lists added to by `listAddAtomic()`
+ *
+ * @param  head  the head variable (struct *) shared by threads; set to NULL
+ * @param  ...   unique link differentiator (unused, for symmetry)
+ * @return       head of the entries taken, the last added one first; see
+ *               `listTakeAllFifo()` for the order of addition
+ */
+#define listTakeAll(head, ...) \
+        __atomic_exchange_n(&(head), NULL, __ATOMIC_ACQUIRE)
+
+
+/**
+ * takes all entries off a list atomically like `listTakeAll()`, in the
+ * order they were added
+ *
+ * @param  head  the head variable (struct *) shared by threads; set to NULL
+ * @param  ...   unique link differentiator (optional)
+ * @return       head of the entries taken, the first added one first
+ * @note         reverses the entries taken, O(n) in their number
+ */
+#define listTakeAllFifo(head, ...)                                            \
+({                                                                            \
+        typeof(head) __all = listTakeAll(head);                               \
+                                                                              \
+        listReverse(__all, __VA_ARGS__);                                      \
+})
+
+
+/*
+ * Read-mostly lists (RCU style): readers traverse without locking, while
+ * writers, serialized among themselves (e.g., by a mutex), publish changes
+ * by release stores, so a reader sees either the old or the new link,
+ * each leading to fully set up entries. Removed entries are left intact
+ * for readers still on them, and are to be freed only when those are
+ * gone, see epoch.h.
+ */
+
+
+/**
+ * gets next list entry for a lock-free reader
+ *
+ * @param  pos   pointer to the list entry (struct *) next of which is got
+ * @param  ...   unique link differentiator (optional)
+ */
+#define listNextRcu(pos, ...) \
+        __atomic_load_n(&(pos)->LIST_LINK_(__VA_ARGS__), __ATOMIC_ACQUIRE)
+
+
+/**
+ * iterates over a list for a lock-free reader
+ *
+ * @param  pos   loop cursor variable (struct *)
+ * @param  head  the head variable (struct *) of list
+ * @param  ...   unique link differentiator (optional)
+ */
+#define listForEachRcu(pos, head, ...)                                        \
+        for(pos = __atomic_load_n(&(head), __ATOMIC_ACQUIRE); pos != NULL;    \
+            pos = listNextRcu(pos, __VA_ARGS__))
+
+
+/**
+ * finds first matching list entry for a lock-free reader
+ *
+ * @param  head   the head variable (struct *) of list
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listFind()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listFind()`
+ * @return        pointer of first true entry, if any; NULL otherwise
+ */
+#define listFindRcu(head, ldif, cmpfn, fld, args...)                          \
+({                                                                            \
+        typeof(head) __i;                                                     \
+                                                                              \
+        listForEachRcu(__i, head, ldif)                                       \
+            if(cmpfn(__i fld, args) == 0)                                     \
+                break;                                                        \
+        __i;                                                                  \
+})
+
+
+/**
+ * inserts new entry to list head, publishing it to lock-free readers
+ *
+ * @param  new   pointer to the new entry, fully set up (struct *)
+ * @param  head  the head variable (struct *) of list; modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       new
+ */
+#define listAddRcu(new, head, ...)                                            \
+({                                                                            \
+        typeof(new) __new = (new);                                            \
+                                                                              \
+        __new->LIST_LINK_(__VA_ARGS__) = head;                                \
+        __atomic_store_n(&(head), __new, __ATOMIC_RELEASE);                   \
+        __new;                                                                \
+})
+
+
+/**
+ * unlinks first matching list entry, leaving its link intact for
+ * lock-free readers still on it
+ *
+ * @param  head   the head variable (struct *) of list; may be modified
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listFind()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listFind()`
+ * @return        pointer of unlinked entry, to be retired (epoch.h) rather
+ *                than freed, if any; NULL otherwise
+ */
+#define listUnlinkRcu(head, ldif, cmpfn, fld, args...)                        \
+({                                                                            \
+        typeof(&(head)) __i;                                                  \
+        typeof(*__i) __entry = NULL;                                          \
+                                                                              \
+        listForEachLink(__i, &(head), ldif)                                   \
+            if(cmpfn((*__i) fld, args) == 0) {                                \
+                __entry = *__i;                                               \
+                __atomic_store_n(__i, __entry->LIST_LINK_(ldif),              \
+                                 __ATOMIC_RELEASE);                           \
+                break;                                                        \
+            }                                                                 \
+        __entry;                                                              \
+})
+
+
+/**
+ * replaces first matching list entry by new one in a single step, so
+ * lock-free readers see either of them, never neither
+ *
+ * @param  new    pointer to the new entry, fully set up (struct *)
+ * @param  head   the head variable (struct *) of list; may be modified
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listFind()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listFind()`
+ * @return        pointer of replaced entry, to be retired (epoch.h) rather
+ *                than freed, if any; NULL if none matches and new is not
+ *                added
+ */
+#define listReplaceRcu(new, head, ldif, cmpfn, fld, args...)                  \
+({                                                                            \
+        typeof(&(head)) __i;                                                  \
+        typeof(*__i) __entry = NULL, __new = (new);                           \
+                                                                              \
+        listForEachLink(__i, &(head), ldif)                                   \
+            if(cmpfn((*__i) fld, args) == 0) {                                \
+                __entry = *__i;                                               \
+                __new->LIST_LINK_(ldif) = __entry->LIST_LINK_(ldif);          \
+                __atomic_store_n(__i, __new, __ATOMIC_RELEASE);               \
+                break;                                                        \
+            }                                                                 \
+        __entry;                                                              \
+})
+
+
 /**
  * finds first matching list entry
  *
@@ -322,4 +512,371 @@
 })
 
 
+/* ----- head/tail descriptor ---------------------------------------------- */
+
+
+/**
+ * declares a list descriptor keeping the tail next to the head, so
+ * entries can be appended and lists concatenated in O(1)
+ *
+ *        desc
+ *        +------+      +------+      +------+
+ *        | head |----> | LINK |----> | LINK |--> NULL
+ *        | tail |--.   +------+  .-> +------+
+ *        +------+  '-------------'
+ *
+ * @param  name  tag of the descriptor struct, so descriptors declared
+ *               apart are of the same type; may be left empty for an
+ *               anonymous struct, each declaration then being a distinct
+ *               type
+ * @param  type  type of list entries (struct)
+ * @note         head can be given to any list macro that does not modify
+ *               it (e.g., `listForEach()`, `listFind()`); after the ones
+ *               modifying it, tail is to be restored by `listDescSetTail()`
+ */
+#define LIST_DESC(name, type) \
+        struct name { type *head; type *tail; }
+
+
+/** initializer of an empty list descriptor */
+#define LIST_DESC_INIT   { NULL, NULL }
+
+
+/**
+ * tests whether list of descriptor is empty
+ *
+ * @param  desc  list descriptor variable
+ */
+#define listDescIsEmpty(desc) \
+        ((desc).head == NULL)
+
+
+/**
+ * inserts new entry to list head
+ *
+ * @param  new   pointer to the new entry that is to be added (struct *)
+ * @param  desc  list descriptor variable to add entry to; modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       new
+ */
+#define listDescAdd(new, desc, ...)                                           \
+({                                                                            \
+        typeof(new) __new = (new);                                            \
+                                                                              \
+        __new->LIST_LINK_(__VA_ARGS__) = (desc).head;                         \
+        if((desc).head == NULL)                                               \
+            (desc).tail = __new;                                              \
+        (desc).head = __new;                                                  \
+})
+
+
+/**
+ * inserts new entry to list tail in O(1)
+ *
+ * @param  new   pointer to the new entry that is to be added (struct *)
+ * @param  desc  list descriptor variable to add entry to; modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       new
+ */
+#define listDescAddTail(new, desc, ...)                                       \
+({                                                                            \
+        typeof(new) __new = (new);                                            \
+                                                                              \
+        __new->LIST_LINK_(__VA_ARGS__) = NULL;                                \
+        if((desc).tail)                                                       \
+            (desc).tail->LIST_LINK_(__VA_ARGS__) = __new;                     \
+        else                                                                  \
+            (desc).head = __new;                                              \
+        (desc).tail = __new;                                                  \
+})
+
+
+/**
+ * removes entry at head (if list is not empty)
+ *
+ * @param  desc  list descriptor variable to remove entry from; modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       head
+ * @warning      removed element's link keeps it original value
+ */
+#define listDescDel(desc, ...)                                                \
+({                                                                            \
+        if((desc).head &&                                                     \
+           ((desc).head = (desc).head->LIST_LINK_(__VA_ARGS__)) == NULL)      \
+            (desc).tail = NULL;                                               \
+        (desc).head;                                                          \
+})
+
+
+/**
+ * concatenates two lists in O(1), moving entries of source list to the
+ * tail of target list
+ *
+ * @param  descT  target list descriptor variable; modified
+ * @param  descS  source list descriptor variable; emptied
+ * @param  ...    unique link differentiator for both lists (optional)
+ * @return        head of target
+ */
+#define listDescCat(descT, descS, ...)                                        \
+({                                                                            \
+        if((descS).head) {                                                    \
+            if((descT).tail)                                                  \
+                (descT).tail->LIST_LINK_(__VA_ARGS__) = (descS).head;         \
+            else                                                              \
+                (descT).head = (descS).head;                                  \
+            (descT).tail = (descS).tail;                                      \
+            (descS).head = (descS).tail = NULL;                               \
+        }                                                                     \
+        (descT).head;                                                         \
+})
+
+
+/**
+ * restores tail of descriptor by walking the list from head, e.g., after
+ * head is modified by a macro not aware of the descriptor
+ *
+ * @param  desc  list descriptor variable; tail is modified
+ * @param  ...   unique link differentiator (optional)
+ * @return       tail
+ */
+#define listDescSetTail(desc, ...)                                            \
+({                                                                            \
+        typeof((desc).tail) __i = (desc).head;                                \
+                                                                              \
+        while(__i && __i->LIST_LINK_(__VA_ARGS__))                            \
+            listStep(__i, __VA_ARGS__);                                       \
+        (desc).tail = __i;                                                    \
+})
+
+
+/* ----- sorting and merging ----------------------------------------------- */
+
+
+/**
+ * merges a sorted list into another sorted list, relinking entries in
+ * place; stable, entries of target come first among equal ones
+ *
+ * @param  headT  the target head variable (struct *) of list to merge into;
+ *                may be modified
+ * @param  headS  the source head variable (struct *) of list to merge
+ *                from; set to NULL
+ * @param  ldif   unique link differentiator for both lists (optional)
+ * @param  cmpfn  compare function, returning less than, equal to, or
+ *                greater than zero like for `qsort()`
+ * @param  fld    member field to be compared, together with the member
+ *                access operator (->), or empty to compare the whole structs
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        headT
+ */
+#define listMerge(headT, headS, ldif, cmpfn, fld, args...)                    \
+({                                                                            \
+        typeof(headT) __a = headT, __b = headS;                               \
+        typeof(&(headT)) __p = &(headT);                                      \
+                                                                              \
+        while(__a && __b)                                                     \
+            if(cmpfn(__b fld, __a fld, ##args) < 0) {                         \
+                *__p = __b;                                                   \
+                __p = &__b->LIST_LINK_(ldif);                                 \
+                __b = __b->LIST_LINK_(ldif);                                  \
+            } else {                                                          \
+                *__p = __a;                                                   \
+                __p = &__a->LIST_LINK_(ldif);                                 \
+                __a = __a->LIST_LINK_(ldif);                                  \
+            }                                                                 \
+        *__p = __a ? __a : __b;                                               \
+        headS = NULL;                                                         \
+        headT;                                                                \
+})
+
+
+/**
+ * merges k sorted lists into the first one, pairwise in rounds, so each
+ * entry is relinked O(log k) times; stable, entries of lists given
+ * earlier come first among equal ones
+ *
+ * @param  heads  array of head variables (struct *[]) of lists to merge;
+ *                the first one gets the result, the others are set to NULL
+ * @param  k      number of lists
+ * @param  ldif   unique link differentiator for all lists (optional)
+ * @param  cmpfn  compare function, see `listMerge()`
+ * @param  fld    member field to be compared, see `listMerge()`
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        the merged list's head; NULL if k is 0
+ */
+#define listMergeK(heads, k, ldif, cmpfn, fld, args...)                       \
+({                                                                            \
+        typeof(&(heads)[0]) __h = (heads);                                    \
+        unsigned long __k = (k), __step, __j;                                 \
+                                                                              \
+        for(__step = 1; __step < __k; __step *= 2)                            \
+            for(__j = 0; __j + __step < __k; __j += 2 * __step)               \
+                listMerge(__h[__j], __h[__j + __step], ldif, cmpfn, fld,      \
+                          ##args);                                            \
+        __k ? __h[0] : NULL;                                                  \
+})
+
+
+/**
+ * sorts list in place by bottom-up merge sort: O(n log n) comparisons,
+ * O(1) extra memory, stable
+ *
+ * Sorted runs of 1, 2, 4, ... entries are merged pairwise in passes over
+ * the list, relinking entries, until a single run is left.
+ *
+ * @param  head   the head variable (struct *) of list to sort; modified
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, see `listMerge()`
+ * @param  fld    member field to be compared, see `listMerge()`
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        head
+ */
+#define listSort(head, ldif, cmpfn, fld, args...)                             \
+({                                                                            \
+        typeof(head) __p, __q, __e, __list = head, __tail = NULL;             \
+        unsigned long __size = 1, __nMerges = 2, __pSize, __qSize;            \
+                                                                              \
+        for(; __list && __nMerges > 1; __size *= 2) {                         \
+            __p = __list;                                                     \
+            __list = __tail = NULL;                                           \
+            for(__nMerges = 0; __p; __nMerges++, __p = __q) {                 \
+                /* run p of size entries followed by run q of at most so */   \
+                for(__q = __p, __pSize = 0; __q && __pSize < __size;          \
+                    __pSize++)                                                \
+                    listStep(__q, ldif);                                      \
+                for(__qSize = __size; __pSize || (__qSize && __q);            \
+                    __tail = __e) {                                           \
+                    if(__pSize && (__qSize == 0 || __q == NULL ||             \
+                                   cmpfn(__q fld, __p fld, ##args) >= 0)) {   \
+                        __e = __p;                                            \
+                        listStep(__p, ldif);                                  \
+                        __pSize--;                                            \
+                    } else {                                                  \
+                        __e = __q;                                            \
+                        listStep(__q, ldif);                                  \
+                        __qSize--;                                            \
+                    }                                                         \
+                    if(__tail)                                                \
+                        __tail->LIST_LINK_(ldif) = __e;                       \
+                    else                                                      \
+                        __list = __e;                                         \
+                }                                                             \
+            }                                                                 \
+            __tail->LIST_LINK_(ldif) = NULL;                                  \
+        }                                                                     \
+        head = __list;                                                        \
+})
+
+
+/* ----- prefetching ------------------------------------------------------- */
+
+
+/*
+ * Prefetching variants for long lists of entries scattered in memory: a
+ * lookahead cursor runs LIST_PREFETCH_DIST entries ahead, prefetching
+ * each entry it reaches, so the cache misses of the hops are taken while
+ * the entries behind are processed, not when the cursor gets there. The
+ * lookahead cursor itself still hops one link at a time, so they only pay
+ * off when processing an entry takes about as long as a miss.
+ */
+
+
+/** number of entries the prefetching macros fetch ahead of the cursor;
+ *  may be defined before including */
+#ifndef LIST_PREFETCH_DIST
+#define LIST_PREFETCH_DIST  4
+#endif
+
+
+/**
+ * steps lookahead cursor to the next entry and prefetches it
+ *
+ * @note  used by the macros below, not to be called directly
+ */
+#define _listAhead(ahead, ...)                                                \
+        (void)((ahead) && ((ahead) = (ahead)->LIST_LINK_(__VA_ARGS__)) &&     \
+               (__builtin_prefetch(ahead), 1))
+
+
+/**
+ * sets lookahead cursor LIST_PREFETCH_DIST entries after head
+ *
+ * @note  used by the macros below, not to be called directly
+ */
+#define _listAheadInit(ahead, head, ...)                                      \
+({                                                                            \
+        int __d;                                                              \
+                                                                              \
+        ahead = head;                                                         \
+        for(__d = 0; __d < LIST_PREFETCH_DIST; __d++)                         \
+            _listAhead(ahead, __VA_ARGS__);                                   \
+})
+
+
+/**
+ * iterates over a list like `listForEach()`, prefetching entries ahead
+ *
+ * @param  pos    loop cursor variable (struct *)
+ * @param  ahead  lookahead cursor variable, same type as loop cursor
+ * @param  head   list head, pointer to first entry (struct *)
+ * @param  ...    unique link differentiator (optional)
+ */
+#define listForEachPrefetch(pos, ahead, head, ...)                            \
+        for(pos = head, _listAheadInit(ahead, pos, __VA_ARGS__);              \
+            pos != NULL;                                                      \
+            listStep(pos, __VA_ARGS__), _listAhead(ahead, __VA_ARGS__))
+
+
+/**
+ * finds first matching list entry like `listFind()`, prefetching entries
+ * ahead
+ *
+ * @param  head   list head, pointer to first element (struct *)
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listFind()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listFind()`
+ * @return        pointer of first true entry, if any; NULL otherwise
+ */
+#define listFindPrefetch(head, ldif, cmpfn, fld, args...)                     \
+({                                                                            \
+        typeof(head) __i, __ahead;                                            \
+                                                                              \
+        listForEachPrefetch(__i, __ahead, head, ldif)                         \
+            if(cmpfn(__i fld, args) == 0)                                     \
+                break;                                                        \
+        __i;                                                                  \
+})
+
+
+/**
+ * deletes each matching list entry like `listDelMatch()`, prefetching
+ * entries ahead
+ *
+ * @param  head   the head variable (struct *) to delete element(s) from list
+ *                pointed by; may be modified
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see `listDelMatch()`
+ * @param  args   arguments to pass over to the compare function, see
+ *                `listDelMatch()`
+ * @return        void
+ */
+#define listDelMatchPrefetch(head, ldif, cmpfn, fld, args...)                 \
+({                                                                            \
+        typeof(&(head)) __i = &(head);                                        \
+        typeof(head) __ahead;                                                 \
+                                                                              \
+        _listAheadInit(__ahead, head, ldif);                                  \
+        for(; *__i; _listAhead(__ahead, ldif))                                \
+            if(cmpfn((*__i) fld, args) == 0)                                  \
+                listDel(*__i, ldif);                                          \
+            else                                                              \
+                __i = &(*__i)->LIST_LINK_(ldif);                              \
+})
+
+
 #endif /* __LIST_H */
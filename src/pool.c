@@ -0,0 +1,117 @@
+/**
+ * @file     pool.c
+ * @brief    fixed-size object pool
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "pool.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** rounds size up to a multiple of a power of two */
+#define ROUND_UP(sz, align)  (((sz) + (align) - 1) & ~((size_t)(align) - 1))
+
+
+/* ----- function definitions ---------------------------------------------- */
+
+
+pool_t *
+poolNew(size_t objSz, size_t align, size_t perSlab)
+{
+    pool_t *p;
+
+    if(align == 0)
+        align = _Alignof(max_align_t);
+    if(perSlab == 0 || (align & (align - 1)))
+        return NULL;
+    if((p = calloc(1, sizeof(*p))) == NULL)
+        return NULL;
+
+    /* free objects have to hold the link */
+    if(objSz < sizeof(poolObj_t))
+        objSz = sizeof(poolObj_t);
+    if(align < _Alignof(poolObj_t))
+        align = _Alignof(poolObj_t);
+
+    p->objSz = objSz;
+    p->align = align;
+    p->stride = ROUND_UP(objSz, align);
+    p->perSlab = perSlab;
+    return p;
+} /* poolNew */
+
+
+poolObj_t *
+_poolRefill(pool_t *p)
+{
+    poolSlab_t *slab;
+    char *obj;
+    size_t i;
+
+    /* objects of slab not to wrap the size around (stride of 0 wrapped
+       around already on rounding up) */
+    if(p->stride == 0 ||
+       p->perSlab > (SIZE_MAX - sizeof(*slab) - p->align) / p->stride)
+        return NULL;
+
+    /* room for aligning the first object, wherever malloc() puts slab */
+    if((slab = malloc(sizeof(*slab) + p->align - 1 +
+                      p->stride * p->perSlab)) == NULL)
+        return NULL;
+    listAdd(slab, p->slabs);
+
+    obj = (char *)ROUND_UP((uintptr_t)(slab + 1), p->align);
+    for(i = 0; i < p->perSlab; i++, obj += p->stride)
+        listAdd((poolObj_t *)obj, p->free);
+    return p->free;
+} /* _poolRefill */
+
+
+size_t
+poolAllocBulk(pool_t *p, void **objs, size_t n)
+{
+    size_t i;
+
+    for(i = 0; i < n; i++)
+        if((objs[i] = poolAlloc(p)) == NULL)
+            break;
+    return i;
+} /* poolAllocBulk */
+
+
+void
+poolFreeBulk(pool_t *p, void **objs, size_t n)
+{
+    poolObj_t *first;
+    size_t i;
+
+    if(n == 0)
+        return;
+
+    /* chained up, then spliced onto the free list at once */
+    for(i = 0; i + 1 < n; i++)
+        ((poolObj_t *)objs[i])->LIST_LINK = objs[i+1];
+    ((poolObj_t *)objs[n-1])->LIST_LINK = p->free;
+    first = objs[0];
+    p->free = first;
+    p->nUsed -= n;
+} /* poolFreeBulk */
+
+
+void
+poolDestroy(pool_t *p)
+{
+    poolSlab_t *slab, *tmpSlab;
+
+    listForEachSafe(slab, tmpSlab, p->slabs)
+        free(slab);
+    free(p);
+} /* poolDestroy */
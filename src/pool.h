@@ -0,0 +1,199 @@
+/**
+ * @file     pool.h
+ * @brief    fixed-size object pool
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Objects of one size are carved out of slabs allocated together, and
+ * freed objects are kept on a free list linked through themselves
+ * (list.h) to be handed out again, so allocation and freeing are a few
+ * instructions inline, calling out of line only when a new slab is
+ * needed. Memory is returned to the system only on destroy. Not for
+ * concurrent use.
+ *
+ *        pool_t                 slab                   slab
+ *        +------+         +------------+         +------------+
+ *        | free | --+     | link       | ------> | link       |
+ *        +------+   |     | (in use)   |         | (free)     | --> ...
+ *                   +---> | (free)     | ----+   | (in use)   |
+ *                         | (in use)   |     +-> | (free)     |
+ *                         +------------+         +------------+
+ *
+ * Usage example, intrusive list nodes from a pool:
+ *
+ *        pool_t *p = poolNew(sizeof(node_t), 0, 256);
+ *        node_t *node = poolAlloc(p);
+ *        listAdd(node, head);
+ *        ...
+ *        listDel(head);
+ *        poolFree(p, node);
+ *        poolDestroy(p);
+ */
+
+
+#ifndef __POOL_H
+#define __POOL_H
+
+
+#include <stddef.h>
+
+#include "list.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/* if not GNU C, elide __attribute__ */
+#ifndef __GNUC__
+#  define __attribute__(x) /* nothing */
+#endif
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct poolObj_t
+{
+    struct poolObj_t *LIST_LINK; /* link to next free object */
+
+} poolObj_t; /* free object */
+
+
+typedef struct poolSlab_t
+{
+    struct poolSlab_t *LIST_LINK; /* link to next slab */
+
+    /* NOTE: objects come after this struct, at the first aligned offset */
+
+} poolSlab_t; /* objects allocated together */
+
+
+typedef struct
+{
+    poolObj_t *free;            /* list of free objects */
+    size_t nUsed;               /* number of objects in use */
+
+    /* members for administrative use only */
+
+    size_t objSz;               /* object size */
+    size_t align;               /* object alignment */
+    size_t stride;              /* distance of objects in slab */
+    size_t perSlab;             /* number of objects per slab */
+    poolSlab_t *slabs;          /* list of slabs */
+
+} pool_t; /* fixed-size object pool */
+
+
+/* ----- function signatures ----------------------------------------------- */
+
+
+/**
+ * creates a new object pool
+ *
+ * @param  objSz    size of objects
+ * @param  align    alignment of objects, a power of two; 0 for that of
+ *                  malloc()
+ * @param  perSlab  number of objects allocated together, at least 1
+ * @return          new pool on success; NULL otherwise
+ */
+pool_t *
+poolNew(size_t objSz, size_t align, size_t perSlab)
+    __attribute__((malloc, warn_unused_result));
+
+
+/**
+ * gets several objects from pool at once
+ *
+ * @param  p     pool
+ * @param  objs  array to put objects into
+ * @param  n     number of objects to get
+ * @return       number of objects got, less than n only if memory could
+ *               not be allocated
+ */
+size_t
+poolAllocBulk(pool_t *p, void **objs, size_t n)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * returns several objects to pool at once
+ *
+ * @param  p     pool
+ * @param  objs  objects got from the pool
+ * @param  n     number of objects
+ */
+void
+poolFreeBulk(pool_t *p, void **objs, size_t n)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * destroys pool, freeing every object of it
+ */
+void
+poolDestroy(pool_t *p)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * allocates a new slab and puts its objects onto the free list
+ *
+ * @return  the free list on success; NULL otherwise
+ * @note    slow path of `poolAlloc()`, not to be called directly
+ */
+poolObj_t *
+_poolRefill(pool_t *p)
+    __attribute__((nonnull(1)));
+
+
+/* ----- inline functions -------------------------------------------------- */
+
+
+/**
+ * gets an object from pool
+ *
+ * @return  object (uninitialized) on success; NULL otherwise
+ */
+static inline void *
+poolAlloc(pool_t *p)
+{
+    poolObj_t *obj;
+
+    if((obj = p->free) || (obj = _poolRefill(p)))
+    {
+        p->free = obj->LIST_LINK;
+        p->nUsed++;
+    }
+    return obj;
+} /* poolAlloc */
+
+
+/**
+ * returns an object to pool
+ *
+ * @param  p    pool
+ * @param  obj  object got from the pool
+ */
+static inline void
+poolFree(pool_t *p, void *obj)
+{
+    poolObj_t *o = (poolObj_t *)obj;
+
+    o->LIST_LINK = p->free;
+    p->free = o;
+    p->nUsed--;
+} /* poolFree */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __POOL_H */
@@ -0,0 +1,347 @@
+/**
+ * @file     skip.h
+ * @brief    intrusive skip list of ordered entries
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Entries are kept in order on up to `SKIP_LEVELS` singly linked lists at
+ * once through an array of their own links (see list.h): every entry is
+ * on level 0, and an entry on a level is also on the next one up with a
+ * probability of 1/4. Searches start on the highest level used and step
+ * down a level when the next entry would overshoot, so finding, adding
+ * and deleting entries are O(log n) on average; nothing is allocated.
+ *
+ *        heads
+ *        +---+                        +---+
+ *        | o |----------------------> | o |--------------------> NULL
+ *        +---+      +---+             +---+      +---+
+ *        | o |----> | o |-----------> | o |----> | o |---------> NULL
+ *        +---+      +---+    +---+    +---+      +---+    +---+
+ *        | o |----> | o |--> | o |--> | o |----> | o |--> | o |--> NULL
+ *        +---+      +---+    +---+    +---+      +---+    +---+
+ *                     1        3        4          7        9
+ *
+ * @param  sl     skip list variable, declared by `SKIP_LIST()`
+ * @param  ldif   unique link differentiator of entries' links (optional,
+ *                see list.h)
+ * @param  cmpfn  compare function, returning less than, equal to, or
+ *                greater than zero like for `qsort()`, called with entry
+ *                field, key and args
+ * @param  fld    member field of entries being the key, together with the
+ *                member access operator (->), or empty to use the whole
+ *                struct
+ *
+ * Usage example:
+ *
+ *        struct timer_t { long when; SKIP_LINKS(struct timer_t,); ... };
+ *        SKIP_LIST(struct timer_t) timers = SKIP_LIST_INIT;
+ *
+ *        skipAdd(timer, timers,, NUMCMP, ->when);
+ *        while((t = skipFirst(timers)) && t->when <= now)
+ *            fire(skipDelFirst(timers));
+ */
+
+
+#ifndef __SKIP_H
+#define __SKIP_H
+
+
+#include "list.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of levels, enough for 4^SKIP_LEVELS entries; may be defined
+ *  before including to trade entry size for capacity */
+#ifndef SKIP_LEVELS
+#define SKIP_LEVELS      12
+#endif
+
+
+/**
+ * declares the links an entry needs to be on a skip list
+ *
+ * @param  type  type of entry (struct)
+ * @param  ldif  unique link differentiator (optional, may be left empty)
+ */
+#define SKIP_LINKS(type, ldif) \
+        type *LIST_LINK_(ldif)[SKIP_LEVELS]
+
+
+/**
+ * declares a skip list of entries of given type
+ *
+ * @param  type  type of entries (struct)
+ */
+#define SKIP_LIST(type)                                                       \
+        struct {                                                              \
+            type *heads[SKIP_LEVELS]; /* first entries of levels */           \
+            int lvl;            /* number of levels in use, at least 1 */     \
+            unsigned long n;    /* number of entries */                       \
+            unsigned long long rnd; /* state of level generator */            \
+        }
+
+
+/** initializer of an empty skip list */
+#define SKIP_LIST_INIT   { { NULL }, 1, 0, 0x9e3779b97f4a7c15ull }
+
+
+/** gets number of entries in skip list */
+#define skipSize(sl) \
+        ((sl).n)
+
+
+/** gets first (lowest) entry of skip list, NULL if empty */
+#define skipFirst(sl) \
+        ((sl).heads[0])
+
+
+/** gets entry after pos in order, NULL if pos is the last */
+#define skipNext(pos, ...) \
+        ((pos)->LIST_LINK_(__VA_ARGS__)[0])
+
+
+/**
+ * iterates over entries of skip list in order
+ *
+ * @param  pos  loop cursor variable (struct *)
+ * @param  sl   skip list variable
+ * @param  ...  unique link differentiator (optional)
+ */
+#define skipForEach(pos, sl, ...) \
+        for(pos = (sl).heads[0]; pos; pos = skipNext(pos, __VA_ARGS__))
+
+
+/**
+ * iterates over entries with keys from lo to hi (inclusive) in order,
+ * after an O(log n) search for the first one
+ *
+ * @param  pos    loop cursor variable (struct *)
+ * @param  sl     skip list variable
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, see above
+ * @param  fld    member field being the key, see above
+ * @param  lo     lowest key
+ * @param  hi     highest key, evaluated for each entry
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ */
+#define skipForEachRange(pos, sl, ldif, cmpfn, fld, lo, hi, args...)          \
+        for(pos = skipSeek(sl, ldif, cmpfn, fld, lo, ##args);                 \
+            pos && cmpfn(pos fld, hi, ##args) <= 0;                           \
+            pos = skipNext(pos, ldif))
+
+
+/**
+ * walks down the levels to the last entry before key on each
+ *
+ * @param  upd   array of SKIP_LEVELS link arrays (struct **[]), set to the
+ *               links pointing past the position on each level in use
+ * @param  past  0 to stop before entries equal to key, 1 to stop after them
+ * @return       entry following the position on level 0, if any
+ * @note         called by the macros below, not to be called directly
+ */
+#define _skipSeek(upd, sl, ldif, cmpfn, fld, key, past, args...)              \
+({                                                                            \
+        typeof((sl).heads[0]) *__lnk = (sl).heads, __nx;                      \
+        int __i;                                                              \
+                                                                              \
+        for(__i = (sl).lvl - 1; __i >= 0; __i--) {                            \
+            while((__nx = __lnk[__i]) &&                                      \
+                  cmpfn(__nx fld, key, ##args) < (past))                      \
+                __lnk = __nx->LIST_LINK_(ldif);                               \
+            upd[__i] = __lnk;                                                 \
+        }                                                                     \
+        __lnk[0];                                                             \
+})
+
+
+/**
+ * links entry in at the position found by `_skipSeek()` on a random
+ * number of levels
+ *
+ * @note  called by the macros below, not to be called directly
+ */
+#define _skipLink(ent, upd, sl, ldif)                                         \
+({                                                                            \
+        unsigned long long __r;                                               \
+        int __l = 1, __j;                                                     \
+                                                                              \
+        /* xorshift64, then two bits per level for 1/4 */                     \
+        (sl).rnd ^= (sl).rnd << 13;                                           \
+        (sl).rnd ^= (sl).rnd >> 7;                                            \
+        (sl).rnd ^= (sl).rnd << 17;                                           \
+        for(__r = (sl).rnd; __l < SKIP_LEVELS && (__r & 3) == 0; __r >>= 2)   \
+            __l++;                                                            \
+        for(; (sl).lvl < __l; (sl).lvl++)                                     \
+            upd[(sl).lvl] = (sl).heads;                                       \
+        for(__j = 0; __j < __l; __j++) {                                      \
+            (ent)->LIST_LINK_(ldif)[__j] = upd[__j][__j];                     \
+            upd[__j][__j] = (ent);                                            \
+        }                                                                     \
+        (sl).n++;                                                             \
+})
+
+
+/**
+ * unlinks entry from the levels it is on, at the position found by
+ * `_skipSeek()`
+ *
+ * @note  called by the macros below, not to be called directly
+ */
+#define _skipUnlink(ent, upd, sl, ldif)                                       \
+({                                                                            \
+        int __j;                                                              \
+                                                                              \
+        for(__j = 0; __j < (sl).lvl && upd[__j][__j] == (ent); __j++)         \
+            upd[__j][__j] = (ent)->LIST_LINK_(ldif)[__j];                     \
+        while((sl).lvl > 1 && (sl).heads[(sl).lvl - 1] == NULL)               \
+            (sl).lvl--;                                                       \
+        (sl).n--;                                                             \
+})
+
+
+/**
+ * finds first entry with key not less than the given one
+ *
+ * @param  sl     skip list variable
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, see above
+ * @param  fld    member field being the key, see above
+ * @param  key    key to seek, evaluated more than once
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        pointer of entry, if any; NULL if all keys are less
+ */
+#define skipSeek(sl, ldif, cmpfn, fld, key, args...)                          \
+({                                                                            \
+        typeof((sl).heads[0]) *__upd[SKIP_LEVELS] __attribute__((unused));    \
+                                                                              \
+        _skipSeek(__upd, sl, ldif, cmpfn, fld, key, 0, ##args);               \
+})
+
+
+/**
+ * finds first entry of given key
+ *
+ * @param  sl     skip list variable
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, see above
+ * @param  fld    member field being the key, see above
+ * @param  key    key to find, evaluated more than once
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        pointer of entry, if any; NULL otherwise
+ */
+#define skipFind(sl, ldif, cmpfn, fld, key, args...)                          \
+({                                                                            \
+        typeof((sl).heads[0]) __hit =                                         \
+            skipSeek(sl, ldif, cmpfn, fld, key, ##args);                      \
+                                                                              \
+        __hit && cmpfn(__hit fld, key, ##args) == 0 ? __hit : NULL;           \
+})
+
+
+/**
+ * adds new entry in order, after the entries of equal key
+ *
+ * @param  new    pointer to the new entry that is to be added (struct *)
+ * @param  sl     skip list variable
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, called with fields of both entries and
+ *                args
+ * @param  fld    member field being the key, see above
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        new
+ */
+#define skipAdd(new, sl, ldif, cmpfn, fld, args...)                           \
+({                                                                            \
+        typeof((sl).heads[0]) __ent = (new), *__upd[SKIP_LEVELS];             \
+                                                                              \
+        _skipSeek(__upd, sl, ldif, cmpfn, fld, __ent fld, 1, ##args);         \
+        _skipLink(__ent, __upd, sl, ldif);                                    \
+        __ent;                                                                \
+})
+
+
+/**
+ * adds new entry in order if an entry of the same key is not yet present
+ *
+ * @param  new    pointer to the new entry that is to be added (struct *)
+ * @param  sl     skip list variable
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, called with fields of both entries and
+ *                args
+ * @param  fld    member field being the key, see above
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        true if entry is added; false if an entry of the same key
+ *                is already present
+ */
+#define skipAddQ(new, sl, ldif, cmpfn, fld, args...)                          \
+({                                                                            \
+        typeof((sl).heads[0]) __ent = (new), __at, *__upd[SKIP_LEVELS];       \
+        int __added = 0;                                                      \
+                                                                              \
+        __at = _skipSeek(__upd, sl, ldif, cmpfn, fld, __ent fld, 0, ##args);  \
+        if(__at == NULL || cmpfn(__at fld, __ent fld, ##args)) {              \
+            _skipLink(__ent, __upd, sl, ldif);                                \
+            __added = 1;                                                      \
+        }                                                                     \
+        __added;                                                              \
+})
+
+
+/**
+ * removes first entry of given key
+ *
+ * @param  sl     skip list variable
+ * @param  ldif   unique link differentiator (optional)
+ * @param  cmpfn  compare function, see above
+ * @param  fld    member field being the key, see above
+ * @param  key    key of entry to remove, evaluated more than once
+ * @param  args   optional additional arguments to pass over to the compare
+ *                function
+ * @return        pointer of removed entry, if any; NULL otherwise
+ * @note          of entries with equal keys, the earliest added one is
+ *                removed; keys are best made unique (e.g., by an id) if
+ *                particular ones are to be removed
+ */
+#define skipDel(sl, ldif, cmpfn, fld, key, args...)                           \
+({                                                                            \
+        typeof((sl).heads[0]) __entry, *__upd[SKIP_LEVELS];                   \
+                                                                              \
+        __entry = _skipSeek(__upd, sl, ldif, cmpfn, fld, key, 0, ##args);     \
+        if(__entry && cmpfn(__entry fld, key, ##args) == 0)                   \
+            _skipUnlink(__entry, __upd, sl, ldif);                            \
+        else                                                                  \
+            __entry = NULL;                                                   \
+        __entry;                                                              \
+})
+
+
+/**
+ * removes first (lowest) entry without a search, e.g., the earliest timer
+ *
+ * @param  sl    skip list variable
+ * @param  ...   unique link differentiator (optional)
+ * @return       pointer of removed entry, if any; NULL if empty
+ */
+#define skipDelFirst(sl, ...)                                                 \
+({                                                                            \
+        typeof((sl).heads[0]) __first = (sl).heads[0], *__upd[SKIP_LEVELS];   \
+        int __k;                                                              \
+                                                                              \
+        if(__first) {                                                         \
+            for(__k = 0; __k < (sl).lvl; __k++)                               \
+                __upd[__k] = (sl).heads;                                      \
+            _skipUnlink(__first, __upd, sl, __VA_ARGS__);                     \
+        }                                                                     \
+        __first;                                                              \
+})
+
+
+#endif /* __SKIP_H */
@@ -10,6 +10,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
 #ifdef UNIT_TESTING
 #include <stdarg.h>
 #include <stddef.h>
@@ -22,6 +25,67 @@
 #include "stk.h"
 
 
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** size of smallest recycled string buffer as a power of two (16 bytes) */
+#define STR_CLASS_MIN  4
+
+/** number of recycled string buffer size classes (up to 64 KiB) */
+#define STR_CLASSES    13
+
+/** size of largest recycled string buffer */
+#define STR_CLASS_MAX  ((size_t)1 << (STR_CLASS_MIN + STR_CLASSES - 1))
+
+/** number of elements of a block reachable before its first watermark
+ *  while tuning */
+#define TUNE_PROBE     8
+
+/** number of episodes in depth history of block size tuning */
+#define TUNE_EPISODES  4
+
+/** gets end of a block, past its last element */
+#define BLK_END(blk)   ((struct stkEl_t *)((blk) + 1) + (blk)->cap)
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+struct stkRecycle_t
+{
+    size_t budget;              /* maximum number of bytes to keep */
+    size_t bytes;               /* number of bytes kept */
+    char *bufs[STR_CLASSES];    /* lists of kept buffers by size class,
+                                   linked through their first bytes */
+
+}; /* popped string buffers kept for reuse */
+
+
+struct stkTune_t
+{
+    size_t minBlkSz;            /* smallest block size */
+    size_t maxBlkSz;            /* largest block size */
+    size_t peak;                /* depth reachable in current episode */
+    size_t peaks[TUNE_EPISODES]; /* peak depth of recent episodes */
+    size_t allocs;              /* blocks allocated in current episode */
+    stkTuneStats_t st;          /* decisions so far */
+
+}; /* automatic block sizing state */
+
+
+typedef struct
+{
+    const stkRun_t *runs;       /* runs to map */
+    size_t nRuns;               /* number of runs */
+    stkMapFn_t map;             /* map function */
+    void *part;                 /* partial result */
+    void *arg;                  /* user argument */
+    pthread_t tid;              /* worker thread */
+    int started;                /* whether worker thread is started */
+
+} stkJob_t; /* map-reduce worker job */
+
+
 /* ----- function definitions ---------------------------------------------- */
 
 
@@ -51,81 +115,657 @@ stkNew(size_t blkSz)
     {
         memset(s, 0, sizeof(*s));
         s->blkSz = blkSz;
+#ifdef STK_STATS
+        if((s->stats = calloc(1, sizeof(*s->stats))) == NULL)
+        {
+            free(s);
+            return NULL;
+        }
+#endif
     }
     return s;
 } /* stkNew */
 
 
+/** frees a block, to its pool if any */
+static void
+blkFree(stk_t *s, stkBlk_t *blk)
+{
+    s->nBlks--;
+    s->blkBytes -= STK_BLK_BYTES(blk->cap);
+    if(s->pool)
+        poolFree(s->pool, blk);
+    else
+        free(blk);
+} /* blkFree */
+
+
+stk_t *
+stkNewPool(pool_t *pool)
+{
+    stk_t *s;
+
+    if(pool->objSz < STK_BLK_BYTES(1))
+        return NULL;
+    if((s = stkNew((pool->objSz - sizeof(stkBlk_t)) / sizeof(stkEl_t))))
+        s->pool = pool;
+    return s;
+} /* stkNewPool */
+
+
 stkEl_t *
 _stkPush(stk_t *s, char type, stkVar_t var)
 {
-    struct stkEl_t *el;
+    switch(type)
+    {
+        case 'i': return _stkPushInt(s, var.i);
+        case 'd': return _stkPushDbl(s, var.d);
+        case 'c': return _stkPushChr(s, var.c);
+        case 'p': return _stkPushPtr(s, var.p);
+        case 's': return _stkPushStr(s, var.s);
+        default: return NULL;
+    }
+} /* _stkPush */
+
+
+/**
+ * sets end of current block so at least room elements fit above the next
+ * usable one; while tuning, only up to the next doubling watermark, noting
+ * the depth reachable
+ *
+ * @note  end is to be set to base for a block just stepped onto
+ */
+static void
+blkReach(stk_t *s, size_t room)
+{
+    struct stkEl_t *end = BLK_END(s->blk);
+    size_t reach;
+
+    if(s->tune)
+    {
+        reach = 2 * (size_t)(s->end - s->base);
+        if(reach < TUNE_PROBE)
+            reach = TUNE_PROBE;
+        if(reach < (size_t)(s->cur - s->base) + room)
+            reach = (size_t)(s->cur - s->base) + room;
+        if(reach < (size_t)(end - s->base))
+            end = s->base + reach;
+        if(s->tune->peak < s->size + (size_t)(end - s->cur))
+            s->tune->peak = s->size + (size_t)(end - s->cur);
+    }
+    s->end = end;
+} /* blkReach */
+
+
+/** sets size of blocks to be allocated, within bounds of tuning */
+static void
+tuneBlkSz(stk_t *s, size_t blkSz)
+{
+    struct stkTune_t *t = s->tune;
 
-    /* get variable wrapper element */
-    if(s->freeEls)
+    if(blkSz < t->minBlkSz)
+        blkSz = t->minBlkSz;
+    if(blkSz > t->maxBlkSz)
+        blkSz = t->maxBlkSz;
+
+    if(blkSz > s->blkSz)
+        t->st.grows++;
+    else if(blkSz < s->blkSz)
+        t->st.shrinks++;
+    s->blkSz = blkSz;
+} /* tuneBlkSz */
+
+
+/** ends an episode of tuning, as the stack got empty: decides on block
+ *  size by depth history and releases blocks if much more than needed */
+static void
+tuneEpisode(stk_t *s)
+{
+    struct stkTune_t *t = s->tune;
+    struct stkBlk_t *blk, *tmpBlk;
+    size_t peak = 0, els, k;
+
+    t->peaks[t->st.episodes++ % TUNE_EPISODES] = t->peak;
+    t->peak = t->allocs = 0;
+    for(k = 0; k < TUNE_EPISODES; k++)
+        if(peak < t->peaks[k])
+            peak = t->peaks[k];
+
+    if(t->st.episodes >= TUNE_EPISODES)
+    {
+        if(4 * peak <= s->blkSz)
+            tuneBlkSz(s, 2 * peak);
+
+        /* all blocks, to be allocated again in the new size */
+        els = (s->blkBytes - s->nBlks * sizeof(stkBlk_t)) / sizeof(stkEl_t);
+        if(els > 2 * peak + s->blkSz)
+        {
+            listForEachSafe(blk, tmpBlk, s->blks)
+                blkFree(s, blk);
+            s->blk = s->blks = NULL;
+            s->cur = s->base = s->end = NULL;
+            t->st.releases++;
+        }
+    }
+
+    if(s->blk)
     {
-        /* from linked list of free ones */
-        el = s->freeEls;
+        s->end = s->base;
+        blkReach(s, 0);
     }
-    else if(s->blks && s->blkEl < (struct stkEl_t *)(s->blks+1) + s->blkSz)
+} /* tuneEpisode */
+
+
+/** frees the current block, being the empty bottom one, so the next one
+ *  stepped up to becomes the bottom */
+static void
+blkDropBottom(stk_t *s)
+{
+    struct stkBlk_t *blk = s->blk;
+
+    if((s->blks = listNext(blk)))
+        s->blks->LIST_LINK_(down) = NULL;
+    blkFree(s, blk);
+    s->blk = NULL;
+    s->cur = s->base = s->end = NULL;
+} /* blkDropBottom */
+
+
+/** steps up to the next block, allocating it if there is none above */
+static stkEl_t *
+blkStepUp(stk_t *s)
+{
+    struct stkBlk_t *blk;
+
+    /* lower block keeps its fill, as a frame may leave it partly used */
+    if(s->blk)
+        s->blk->n = s->cur - s->base;
+
+    if((blk = s->blk ? listNext(s->blk) : s->blks))
     {
-        /* from already allocated block */
-        el = s->blkEl;
+        /* step up to spare block */
+#ifdef STK_STATS
+        if(s->stats)
+            s->stats->blkReuses++;
+#endif
     }
     else
     {
+        /* more than one block allocated in an episode, stack goes deep */
+        if(s->tune && s->tune->allocs++)
+            tuneBlkSz(s, 2 * s->blkSz);
+
         /* allocate new block */
-        if((el = malloc(sizeof(struct stkBlk_t) +
-                        sizeof(struct stkEl_t) * s->blkSz)) == NULL)
+        if((blk = s->pool ? poolAlloc(s->pool) :
+                            malloc(STK_BLK_BYTES(s->blkSz))) == NULL)
             return NULL;
-        listAdd((struct stkBlk_t *)el, s->blks);
-        s->blkEl = (struct stkEl_t *)((struct stkBlk_t *)el + 1);
+        blk->cap = s->blkSz;
+        blk->LIST_LINK = NULL;
+        blk->LIST_LINK_(down) = s->blk;
+        if(s->blk)
+            s->blk->LIST_LINK = blk;
+        else
+            s->blks = blk;
+#ifdef STK_STATS
+        if(s->stats)
+            s->stats->blkAllocs++;
+#endif
+        s->nBlks++;
+        s->blkBytes += STK_BLK_BYTES(blk->cap);
+        if(s->tune)
+            s->tune->st.allocs++;
+    }
+
+    s->blk = blk;
+    s->base = s->cur = s->end = (struct stkEl_t *)(blk + 1);
+    blkReach(s, 0);
 
-        /* from just allocated block */
-        el = s->blkEl;
+    return s->cur;
+} /* blkStepUp */
+
+
+stkEl_t *
+_stkGrow(stk_t *s)
+{
+    /* only a watermark of the current block is reached */
+    if(s->blk && s->end < BLK_END(s->blk))
+    {
+        blkReach(s, 1);
+        return s->cur;
     }
+    return blkStepUp(s);
+} /* _stkGrow */
+
+
+stkEl_t *
+_stkShrink(stk_t *s)
+{
+    struct stkBlk_t *down;
 
-    /* initialize wrapper element */
-    switch(el->type = type)
+    /* bottom block got empty, keep it current */
+    if((down = listNext(s->blk, down)) == NULL)
     {
-        case 'i': el->var.i = var.i; break;
-        case 'd': el->var.d = var.d; break;
-        case 'c': el->var.c = var.c; break;
-        case 'p': el->var.p = var.p; break;
-        case 's': if((el->var.s = strdup(var.s)) == NULL)
-                      return NULL;
-                  break;
-        default: return NULL;
+        if(s->tune)
+            tuneEpisode(s);
+        return NULL;
     }
 
-    /* push element into stack */
-    if(el == s->freeEls)
-        listMove(s->top, s->freeEls);
-    else /* el == s->blkEl */
-        listAdd(s->blkEl++, s->top);
+    /* step down to the lower block */
+    s->blk = down;
+    s->base = (struct stkEl_t *)(down + 1);
+    s->cur = s->base + down->n;
+    s->end = BLK_END(down);
 
-    return el;
-} /* _stkPush */
+    return s->cur - 1;
+} /* _stkShrink */
 
 
 stkEl_t *
-stkPop(stk_t *s)
+_stkPeekDeep(stk_t *s, size_t n)
 {
-    if(s->top)
+    struct stkBlk_t *blk = listNext(s->blk, down);
+
+    while(n >= blk->n)
+    {
+        n -= blk->n;
+        listStep(blk, down);
+    }
+
+    return (struct stkEl_t *)(blk + 1) + blk->n - 1 - n;
+} /* _stkPeekDeep */
+
+
+/** gets size class of recycled string buffer able to hold size bytes */
+static int
+strClass(size_t size)
+{
+    int k = 0;
+
+    while(((size_t)1 << (STR_CLASS_MIN + k)) < size)
+        k++;
+    return k;
+} /* strClass */
+
+
+/** frees recycled string buffers, largest ones first, till within budget */
+static void
+recycleFree(struct stkRecycle_t *rc, size_t budget)
+{
+    int k;
+    char *buf;
+
+    for(k = STR_CLASSES - 1; k >= 0 && rc->bytes > budget; k--)
+        while(rc->bytes > budget && (buf = rc->bufs[k]))
+        {
+            rc->bufs[k] = *(char **)buf;
+            rc->bytes -= (size_t)1 << (STR_CLASS_MIN + k);
+            free(buf);
+        }
+} /* recycleFree */
+
+
+char *
+_stkStrDup(stk_t *s, const char *str)
+{
+    struct stkRecycle_t *rc = s->recycle;
+    size_t size = strlen(str) + 1;
+    char *buf;
+    int k;
+
+#ifdef STK_STATS
+    if(s->stats)
+        s->stats->strBytes += size;
+#endif
+    if(rc == NULL || size > STR_CLASS_MAX)
+    {
+        if((buf = strdup(str)))
+            s->nStrs++;
+        return buf;
+    }
+
+    /* from the list of its size class, or allocated in full class size */
+    k = strClass(size);
+    if((buf = rc->bufs[k]))
+    {
+        rc->bufs[k] = *(char **)buf;
+        rc->bytes -= (size_t)1 << (STR_CLASS_MIN + k);
+#ifdef STK_STATS
+        if(s->stats)
+            s->stats->strReuses++;
+#endif
+    }
+    else if((buf = malloc((size_t)1 << (STR_CLASS_MIN + k))) == NULL)
+        return NULL;
+
+    s->nStrs++;
+    return memcpy(buf, str, size);
+} /* _stkStrDup */
+
+
+void
+_stkStrFree(stk_t *s, char *str)
+{
+    struct stkRecycle_t *rc = s->recycle;
+    size_t size = strlen(str) + 1;
+    int k;
+
+#ifdef STK_STATS
+    if(s->stats)
+        s->stats->strBytes -= size;
+#endif
+    s->nStrs--;
+    /* buffers pushed while recycling is on are of full class size */
+    if(rc && size <= STR_CLASS_MAX &&
+       rc->bytes + ((size_t)1 << (STR_CLASS_MIN + (k = strClass(size)))) <=
+       rc->budget)
     {
-        if(s->top->type == 's')
-            free(s->top->var.s);
-        listMove(s->freeEls, s->top);
+        *(char **)str = rc->bufs[k];
+        rc->bufs[k] = str;
+        rc->bytes += (size_t)1 << (STR_CLASS_MIN + k);
+        return;
     }
+    free(str);
+} /* _stkStrFree */
+
+
+stkEl_t *
+stkPushFrame(stk_t *s, size_t n, const char *types, const stkVar_t *vals)
+{
+    stkEl_t *hdr;
+    stkBlk_t *up;
+    size_t i;
+    int stepped = 0;
+
+    /* header and values in one run, in the current block or the next */
+    if(s->blk == NULL || (size_t)(BLK_END(s->blk) - s->cur) < n + 1)
+    {
+        up = s->blk ? listNext(s->blk) : s->blks;
+        if(n >= (up ? up->cap : s->blkSz))
+            return NULL;
+        /* no empty block is left below, the bottom one (of a trimmed or
+           tuned stack) is given up instead */
+        if(s->blk && s->cur == s->base)
+            blkDropBottom(s);
+        if(blkStepUp(s) == NULL)
+            return NULL;
+        stepped = 1;
+    }
+    if((size_t)(s->end - s->cur) < n + 1)
+        blkReach(s, n + 1);
+    hdr = s->cur;
+
+    for(i = 0; i < n; i++)
+    {
+        hdr[i+1].type = types[i];
+        switch(types[i])
+        {
+            case 'i': case 'd': case 'c': case 'p':
+                if(vals)
+                    hdr[i+1].var = vals[i];
+                else
+                    memset(&hdr[i+1].var, 0, sizeof(hdr[i+1].var));
+                break;
+            case 's':
+                if((hdr[i+1].var.s = _stkStrDup(s, vals ? vals[i].s : "")))
+                    break;
+                /* FALLTHROUGH */
+            default:
+                while(i--)
+                    if(hdr[i+1].type == 's')
+                        _stkStrFree(s, hdr[i+1].var.s);
+                /* back to the block of top, if stepped up from one */
+                if(stepped && listNext(s->blk, down))
+                    _stkShrink(s);
+                return NULL;
+        }
+    }
+
+    hdr->type = 'f';
+    hdr->var.p = s->frame;
+    s->frame = hdr;
+    s->top = hdr + n;
+    s->cur = hdr + n + 1;
+    s->size += n + 1;
+#ifdef STK_STATS
+    if(s->stats)
+    {
+        s->stats->pushes += n + 1;
+        if(s->size > s->stats->hwm)
+            s->stats->hwm = s->size;
+    }
+#endif
+    return hdr + 1;
+} /* stkPushFrame */
+
+
+stkEl_t *
+stkPopFrame(stk_t *s)
+{
+    stkEl_t *hdr = s->frame;
+    size_t n = 0;
+
+    if(hdr == NULL)
+        return s->top;
+
+    /* strings are to be freed one by one */
+    if(s->nStrs)
+    {
+        while(s->frame == hdr)
+            stkPop(s);
+        return s->top;
+    }
+
+    /* whole blocks pushed above the frame */
+    while(hdr < s->base || hdr >= s->cur)
+    {
+        n += s->cur - s->base;
+        s->cur = s->base;
+        _stkShrink(s);
+    }
+
+    n += s->cur - hdr;
+    s->size -= n;
+    s->frame = (stkEl_t *)hdr->var.p;
+    s->cur = hdr;
+    s->top = hdr > s->base ? hdr - 1 : _stkShrink(s);
+#ifdef STK_STATS
+    if(s->stats)
+        s->stats->pops += n;
+#endif
+    return s->top;
+} /* stkPopFrame */
+
+
+size_t
+stkBorrowSpan(stk_t *s, size_t n, stkSpan_t *span)
+{
+    struct stkBlk_t *blk;
+    stkEl_t *first, *el;
+    stkRun_t run;
+    size_t used, k, i;
+
+    if(n > s->size)
+        n = s->size;
+    span->n = span->nRuns = span->nStrs = span->strBytes = 0;
+
+    /* from the top downwards, skipping blocks left empty by frames */
+    for(blk = s->blk; blk && span->n < n && span->nRuns < STK_SPAN_RUNS;
+        listStep(blk, down))
+    {
+        first = (struct stkEl_t *)(blk + 1);
+        if((used = blk == s->blk ? (size_t)(s->cur - first) : blk->n) == 0)
+            continue;
+        run.n = used < n - span->n ? used : n - span->n;
+        run.els = first + used - run.n;
+        span->runs[span->nRuns++] = run;
+        span->n += run.n;
+    }
+
+    /* runs are given from the bottom upwards */
+    for(k = 0; k < span->nRuns / 2; k++)
+    {
+        run = span->runs[k];
+        span->runs[k] = span->runs[span->nRuns - 1 - k];
+        span->runs[span->nRuns - 1 - k] = run;
+    }
+
+    /* strings counted, those taken over to be uncounted on release */
+    for(k = 0; s->nStrs && k < span->nRuns; k++)
+        for(i = 0, el = span->runs[k].els; i < span->runs[k].n; i++, el++)
+            if(el->type == 's')
+            {
+                span->nStrs++;
+#ifdef STK_STATS
+                span->strBytes += strlen(el->var.s) + 1;
+#endif
+            }
+    return span->n;
+} /* stkBorrowSpan */
+
+
+/** tests whether an element is within a borrowed span */
+static int
+spanHas(const stkSpan_t *span, const stkEl_t *el)
+{
+    size_t k;
+
+    for(k = 0; k < span->nRuns; k++)
+        if(el >= span->runs[k].els && el < span->runs[k].els + span->runs[k].n)
+            return 1;
+    return 0;
+} /* spanHas */
+
+
+stkEl_t *
+stkReleaseSpan(stk_t *s, const stkSpan_t *span)
+{
+    stkEl_t *el, *bottom;
+    size_t k, i, nStrs = span->nStrs;
+#ifdef STK_STATS
+    size_t strBytes = span->strBytes;
+#endif
+
+    if(span->n == 0)
+        return s->top;
+
+    /* strings are to be freed, those taken over only uncounted; frames in
+       span to be left */
+    for(k = 0; span->nStrs && k < span->nRuns; k++)
+        for(i = 0, el = span->runs[k].els; i < span->runs[k].n; i++, el++)
+            if(el->type == 's')
+            {
+                nStrs--;
+#ifdef STK_STATS
+                strBytes -= strlen(el->var.s) + 1;
+#endif
+                _stkStrFree(s, el->var.s);
+            }
+    s->nStrs -= nStrs;
+#ifdef STK_STATS
+    if(s->stats)
+        s->stats->strBytes -= strBytes;
+#endif
+    while(s->frame && spanHas(span, s->frame))
+        s->frame = (stkEl_t *)s->frame->var.p;
+
+    /* whole blocks above the bottom of span */
+    bottom = span->runs[0].els;
+    while(bottom < s->base || bottom >= s->cur)
+    {
+        s->cur = s->base;
+        _stkShrink(s);
+    }
+
+    s->size -= span->n;
+    s->cur = bottom;
+    s->top = bottom > s->base ? bottom - 1 : _stkShrink(s);
+#ifdef STK_STATS
+    if(s->stats)
+        s->stats->pops += span->n;
+#endif
     return s->top;
-} /* stkPop */
+} /* stkReleaseSpan */
+
+
+int
+stkStrRecycle(stk_t *s, size_t budget)
+{
+    if(budget == 0)
+    {
+        /* turn off */
+        if(s->recycle)
+            recycleFree(s->recycle, 0);
+        free(s->recycle);
+        s->recycle = NULL;
+        return 0;
+    }
+
+    if(s->recycle == NULL)
+    {
+        /* turn on, strings of exact size must not be recycled */
+        if(s->nStrs ||
+           (s->recycle = calloc(1, sizeof(*s->recycle))) == NULL)
+            return -1;
+    }
+    s->recycle->budget = budget;
+    recycleFree(s->recycle, budget);
+    return 0;
+} /* stkStrRecycle */
+
+
+void
+stkTrim(stk_t *s)
+{
+    struct stkBlk_t *spare, *tmpBlk;
+
+    if(s->recycle)
+        recycleFree(s->recycle, 0);
+
+    if(s->blk == NULL)
+        return;
+    if(stkIsEmpty(s))
+    {
+        /* all blocks, starting over from scratch on next push */
+        spare = s->blks;
+        s->blk = s->blks = NULL;
+        s->cur = s->base = s->end = NULL;
+    }
+    else
+    {
+        spare = listNext(s->blk);
+        s->blk->LIST_LINK = NULL;
+    }
+    listForEachSafe(spare, tmpBlk, spare)
+        blkFree(s, spare);
+} /* stkTrim */
 
 
 void
 stkClear(stk_t *s)
 {
-    while(stkPop(s))
-        ;
+    if(stkIsEmpty(s))
+        return;
+    if(s->nStrs)
+    {
+        while(stkPop(s))
+            ;
+        return;
+    }
+
+    /* nothing to free, back to the bottom block at once */
+#ifdef STK_STATS
+    if(s->stats)
+        s->stats->pops += s->size;
+#endif
+    s->top = s->frame = NULL;
+    s->size = 0;
+    if((s->blk = s->blks))
+    {
+        s->base = s->cur = (struct stkEl_t *)(s->blk + 1);
+        s->end = BLK_END(s->blk);
+    }
+    if(s->tune)
+        tuneEpisode(s);
 } /* stkClear */
 
 
@@ -136,7 +776,10 @@ stkDestroy(stk_t *s)
 
     stkClear(s);
     listForEachSafe(blk, tmpBlk, s->blks)
-        free(blk);
+        blkFree(s, blk);
+    stkStrRecycle(s, 0);
+    free(s->tune);
+    free(s->stats);
     free(s);
     return;
 } /* stkDestroy */
@@ -161,3 +804,248 @@ stkValToStr(stk_t *s)
     }
     return str;
 } /* stkValToStr */
+
+
+int
+stkTune(stk_t *s, size_t minBlkSz, size_t maxBlkSz)
+{
+    if(maxBlkSz == 0)
+    {
+        /* turn off, whole current block usable again */
+        free(s->tune);
+        s->tune = NULL;
+        if(s->blk)
+            s->end = BLK_END(s->blk);
+        return 0;
+    }
+
+    /* blocks of a pool are all the same size */
+    if(minBlkSz == 0 || minBlkSz > maxBlkSz || s->pool)
+        return -1;
+    if(s->tune == NULL && (s->tune = calloc(1, sizeof(*s->tune))) == NULL)
+        return -1;
+    s->tune->minBlkSz = minBlkSz;
+    s->tune->maxBlkSz = maxBlkSz;
+    if(s->blkSz < minBlkSz)
+        s->blkSz = minBlkSz;
+    if(s->blkSz > maxBlkSz)
+        s->blkSz = maxBlkSz;
+    return 0;
+} /* stkTune */
+
+
+int
+stkTuneStats(const stk_t *s, stkTuneStats_t *out)
+{
+    size_t k;
+
+    if(s->tune == NULL)
+        return -1;
+
+    *out = s->tune->st;
+    out->blkSz = s->blkSz;
+    out->peak = s->tune->peak;
+    for(k = 0; k < TUNE_EPISODES; k++)
+        if(out->peak < s->tune->peaks[k])
+            out->peak = s->tune->peaks[k];
+    return 0;
+} /* stkTuneStats */
+
+
+/** sets iterator bounds to the used elements of a block */
+static void
+stkIterSetBlk(stkIter_t *it, stkBlk_t *blk)
+{
+    it->blk = blk;
+    it->first = (struct stkEl_t *)(blk + 1);
+    it->last = blk == it->s->blk ? it->s->top : it->first + blk->n - 1;
+} /* stkIterSetBlk */
+
+
+/** sets iterator past the end */
+static stkEl_t *
+stkIterEnd(stkIter_t *it)
+{
+    it->blk = NULL;
+    it->first = it->last = NULL;
+    return it->el = NULL;
+} /* stkIterEnd */
+
+
+stkEl_t *
+stkIterTop(const stk_t *s, stkIter_t *it)
+{
+    it->s = s;
+    if(stkIsEmpty(s))
+        return stkIterEnd(it);
+    stkIterSetBlk(it, s->blk);
+    return it->el = it->last;
+} /* stkIterTop */
+
+
+stkEl_t *
+stkIterBottom(const stk_t *s, stkIter_t *it)
+{
+    it->s = s;
+    if(stkIsEmpty(s))
+        return stkIterEnd(it);
+    stkIterSetBlk(it, s->blks);
+    return it->el = it->first;
+} /* stkIterBottom */
+
+
+stkEl_t *
+_stkIterDownBlk(stkIter_t *it)
+{
+    if(it->blk == NULL || listNext(it->blk, down) == NULL)
+        return stkIterEnd(it);
+    stkIterSetBlk(it, listNext(it->blk, down));
+    return it->el = it->last;
+} /* _stkIterDownBlk */
+
+
+stkEl_t *
+_stkIterUpBlk(stkIter_t *it)
+{
+    if(it->blk == NULL || it->blk == it->s->blk)
+        return stkIterEnd(it);
+    stkIterSetBlk(it, listNext(it->blk));
+    return it->el = it->first;
+} /* _stkIterUpBlk */
+
+
+/** maps each run of a job (worker thread entry point) */
+static void *
+stkMapJob(void *arg)
+{
+    stkJob_t *job = arg;
+    size_t i;
+
+    for(i = 0; i < job->nRuns; i++)
+        job->map(job->runs[i].els, job->runs[i].n, job->part, job->arg);
+    return NULL;
+} /* stkMapJob */
+
+
+int
+stkMapReduce(const stk_t *s, unsigned nThreads, stkMapFn_t map,
+             stkReduceFn_t reduce, void *acc, size_t accSz, void *arg)
+{
+    stkRun_t *runs;
+    stkJob_t *jobs;
+    char *parts;
+    stkIter_t it;
+    size_t nRuns, k;
+
+    if(stkIsEmpty(s))
+        return 0;
+
+    /* collect runs block by block, from the bottom upwards */
+    nRuns = 0;
+    for(stkIterBottom(s, &it); it.el; _stkIterUpBlk(&it))
+        nRuns++;
+    if((runs = malloc(sizeof(*runs) * nRuns)) == NULL)
+        return -1;
+    nRuns = 0;
+    for(stkIterBottom(s, &it); it.el; _stkIterUpBlk(&it))
+    {
+        runs[nRuns].els = it.first;
+        runs[nRuns++].n = it.last - it.first + 1;
+    }
+
+    /* distribute runs among workers */
+    if(nThreads == 0)
+    {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nThreads = n > 0 ? n : 1;
+    }
+    if(nThreads > nRuns)
+        nThreads = nRuns;
+    jobs = malloc(sizeof(*jobs) * nThreads);
+    parts = malloc(accSz * nThreads + 1);
+    if(jobs == NULL || parts == NULL)
+    {
+        free(jobs);
+        free(parts);
+        free(runs);
+        return -1;
+    }
+    for(k = 0; k < nThreads; k++)
+    {
+        jobs[k].runs = runs + k * nRuns / nThreads;
+        jobs[k].nRuns = (k + 1) * nRuns / nThreads - k * nRuns / nThreads;
+        jobs[k].map = map;
+        jobs[k].part = memcpy(parts + k * accSz, acc, accSz);
+        jobs[k].arg = arg;
+        jobs[k].started = k > 0 &&
+            pthread_create(&jobs[k].tid, NULL, stkMapJob, &jobs[k]) == 0;
+    }
+
+    /* first job and the ones whose thread could not be started are run
+       in the caller's thread */
+    for(k = 0; k < nThreads; k++)
+        if(!jobs[k].started)
+            stkMapJob(&jobs[k]);
+
+    /* reduce partial results in order */
+    for(k = 0; k < nThreads; k++)
+    {
+        if(jobs[k].started)
+            pthread_join(jobs[k].tid, NULL);
+        reduce(acc, jobs[k].part, arg);
+    }
+
+    free(jobs);
+    free(parts);
+    free(runs);
+    return 0;
+} /* stkMapReduce */
+
+
+int
+stkStats(const stk_t *s, stkStats_t *out)
+{
+    if(s->stats == NULL)
+        return -1;
+
+    *out = *s->stats;
+    out->blkHits = out->pushes > out->blkReuses + out->blkAllocs ?
+        out->pushes - out->blkReuses - out->blkAllocs : 0;
+    out->bytesReserved = s->blkBytes;
+    out->bytesLive = s->size * sizeof(struct stkEl_t) + out->strBytes;
+    out->strRecycled = s->recycle ? s->recycle->bytes : 0;
+    return 0;
+} /* stkStats */
+
+
+int
+stkStatsSample(stk_t *s, size_t every)
+{
+    if(s->stats == NULL)
+        return -1;
+
+    s->stats->sampleEvery = s->stats->sampleIn = every;
+    return 0;
+} /* stkStatsSample */
+
+
+unsigned long long
+_stkStatsClock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+} /* _stkStatsClock */
+
+
+void
+_stkStatsSample(stk_t *s, unsigned long long t0)
+{
+    unsigned long long dt = _stkStatsClock() - t0;
+    int k = 0;
+
+    while(dt >>= 1)
+        k++;
+    s->stats->latency[k < STK_STATS_BUCKETS ? k : STK_STATS_BUCKETS-1]++;
+} /* _stkStatsSample */
@@ -11,18 +11,24 @@
  * small blocks, but never shrinks. Stack always holds a copy of
  * pushed variables, even for strings.
  *
+ * Elements are stored contiguously within blocks that are chained in both
+ * directions, so the element at any depth is reached by stepping over whole
+ * blocks; blocks above the current one are kept as spare ones for reuse.
+ * A block below the current one is full, unless a frame (see
+ * `stkPushFrame()`) did not fit into its rest.
+ *
  *        stk_t *
  *        |
  *        v
- *        +--------------+
- *        | value | type |
- *        +--------------+
- *        | value | type |
- *        +--------------+
- *        | ...          |
- *        +--------------+
- *        | value | type |
- *        +--------------+
+ *        +--------------+        +--------------+
+ *        | (spare)      |        | ...          |
+ *        +--------------+        +--------------+
+ *        | value | type | <-top  | value | type |
+ *        +--------------+        +--------------+
+ *        | ...          |        | ...          |
+ *        +--------------+ -----> +--------------+
+ *        | value | type |  down  | value | type |
+ *        +--------------+        +--------------+
  *
  * Usage example:
  *
@@ -41,6 +47,12 @@
 #include <stdlib.h>
 
 #include "list.h"
+#include "pool.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 
 /* ----- macros ------------------------------------------------------------ */
@@ -52,19 +64,32 @@
 #endif
 
 
-/** pushes variable into stack by type */
+/** pushes variable into stack by type given at run time */
 #define stkPush(s, type, var) \
         _stkPush(s, type, (stkVar_t)(var))
 #define stkPushInt(s, Int) \
-        stkPush(s, 'i', (int)Int)    /**< pushes integer into stack */
+        _stkPushInt(s, (int)(Int))           /**< pushes integer into stack */
 #define stkPushDbl(s, Dbl) \
-        stkPush(s, 'd', (double)Dbl) /**< pushes double into stack */
+        _stkPushDbl(s, (double)(Dbl))        /**< pushes double into stack */
 #define stkPushChr(s, Chr) \
-        stkPush(s, 'c', (char)Chr)   /**< pushes character into stack */
+        _stkPushChr(s, (char)(Chr))          /**< pushes character into stack */
 #define stkPushStr(s, Str) \
-        stkPush(s, 's', (char *)Str) /**< pushes string into stack */
+        _stkPushStr(s, (const char *)(Str))  /**< pushes string into stack */
 #define stkPushPtr(s, Ptr) \
-        stkPush(s, 'p', (void *)Ptr) /**< pushes pointer into stack */
+        _stkPushPtr(s, (void *)(Ptr))        /**< pushes pointer into stack */
+
+/** gets size of a block of given number of elements, e.g., for a pool of
+ *  blocks, see `stkNewPool()` */
+#define STK_BLK_BYTES(blkSz) \
+        (sizeof(stkBlk_t) + sizeof(stkEl_t) * (blkSz))
+
+/** gets element at given index in topmost frame, see `stkPushFrame()` */
+#define stkFrameEl(s, i) \
+        ((s)->frame + 1 + (i))
+
+/** gets number of elements in stack */
+#define stkSize(s) \
+        ((s)->size)
 
 /** tests whether stack is empty */
 #define stkIsEmpty(s) \
@@ -92,12 +117,49 @@
         (stkVal(s).d) /**< gets top value as double, use only if stkIsDbl */
 #define stkValChr(s) \
         (stkVal(s).c) /**< gets top value as character, use only if stkIsChr */
-#define stkValStr(s) \
-        (stkVal(s).s) /**< gets top value as string, use only if stkIsStr */
+#define stkValStr(stk) \
+        (stkVal(stk).s) /**< gets top value as string, use only if stkIsStr */
 #define stkValPtr(s) \
         (stkVal(s).p) /**< gets top as pointer, only if stkIsPtr || stkIsStr */
 /* NOTE: stkValToStr() is also available (defined as function) */
 
+/** finds topmost element holding given typed value, see `stkFind()` */
+#define stkFindInt(s, Int) \
+        stkFind(s, 'i', (stkVar_t)(int)(Int))
+#define stkFindDbl(s, Dbl) \
+        stkFind(s, 'd', (stkVar_t)(double)(Dbl))
+#define stkFindChr(s, Chr) \
+        stkFind(s, 'c', (stkVar_t)(char)(Chr))
+#define stkFindStr(s, Str) \
+        stkFind(s, 's', (stkVar_t)(char *)(Str))
+#define stkFindPtr(s, Ptr) \
+        stkFind(s, 'p', (stkVar_t)(void *)(Ptr))
+
+/** number of buckets in latency histogram of statistics */
+#define STK_STATS_BUCKETS 32
+
+/** maximum number of runs of a borrowed span, see `stkBorrowSpan()` */
+#define STK_SPAN_RUNS 4
+
+/** SIMD instruction set levels for searching, see `stkSetSimd()` */
+#define STK_SIMD_NONE 0         /**< scalar loops only */
+#define STK_SIMD_SSE2 1         /**< SSE2 kernels */
+#define STK_SIMD_AVX2 2         /**< AVX2 kernels */
+
+/**
+ * iterates over stack elements from top to bottom without removing them
+ *
+ * @param  el  loop cursor variable (stkEl_t *)
+ * @param  it  iterator state variable (stkIter_t)
+ * @param  s   stack to iterate over; must not be modified meanwhile
+ */
+#define stkForEach(el, it, s) \
+        for(el = stkIterTop(s, &(it)); el != NULL; el = stkIterDown(&(it)))
+
+/** iterates over stack elements from bottom to top, see `stkForEach()` */
+#define stkForEachRev(el, it, s) \
+        for(el = stkIterBottom(s, &(it)); el != NULL; el = stkIterUp(&(it)))
+
 
 /* ----- types ------------------------------------------------------------- */
 
@@ -117,14 +179,17 @@ typedef struct stkEl_t
 {
     stkVar_t var;               /* variable, must be the first member */
     char type;                  /* type of variable */
-    struct stkEl_t *LIST_LINK;  /* link to next element on list */
 
 } stkEl_t; /* stack variable wrapper element */
 
 
 typedef struct stkBlk_t
 {
-    struct stkBlk_t *LIST_LINK; /* link to next allocated block on list */
+    struct stkBlk_t *LIST_LINK; /* link to next upper block on list */
+    struct stkBlk_t *LIST_LINK_(down); /* link to next lower block */
+    size_t n;                   /* number of used elements, kept only while
+                                   block is below the current one */
+    size_t cap;                 /* number of elements the block holds */
 
     /* NOTE: actually the utilisable space that is allocated as block
              comes after this struct */
@@ -134,19 +199,138 @@ typedef struct stkBlk_t
 
 typedef struct
 {
-    stkEl_t *top;               /* stack top (linked list of used elements) */
+    size_t pushes;              /* number of pushes */
+    size_t pops;                /* number of pops (of non-empty stack) */
+    size_t hwm;                 /* high-water mark of stack size */
+    size_t blkHits;             /* pushes served by the current block */
+    size_t blkReuses;           /* pushes served by stepping up to a spare
+                                   block */
+    size_t blkAllocs;           /* pushes served by allocating a block */
+    size_t strBytes;            /* bytes held by string duplicates */
+    size_t strReuses;           /* string pushes served by a recycled
+                                   buffer */
+    size_t strRecycled;         /* bytes of popped string buffers kept for
+                                   reuse */
+    size_t bytesReserved;       /* bytes allocated for blocks */
+    size_t bytesLive;           /* bytes of elements in use and strings */
+    size_t latency[STK_STATS_BUCKETS]; /* histogram of sampled push and pop
+                                   latencies; bucket k counts samples of
+                                   [2^k, 2^(k+1)) nanoseconds */
+
+    /* members for administrative use only */
+
+    size_t sampleEvery;         /* sampling period in operations, 0 if off */
+    size_t sampleIn;            /* operations left till next sample */
+
+} stkStats_t; /* stack statistics, see `stkStats()` */
+
+
+typedef struct
+{
+    size_t blkSz;               /* size of blocks to be allocated next */
+    size_t peak;                /* peak depth of recent episodes (at most
+                                   twice the real one, as observed) */
+    size_t episodes;            /* number of episodes, each ending when
+                                   the stack gets empty */
+    size_t allocs;              /* number of blocks allocated */
+    size_t grows;               /* decisions raising block size */
+    size_t shrinks;             /* decisions lowering block size */
+    size_t releases;            /* decisions releasing all blocks of the
+                                   emptied stack, as oversized */
+
+} stkTuneStats_t; /* block size tuning decisions, see `stkTuneStats()` */
+
+
+typedef struct stk_t
+{
+    stkEl_t *top;               /* stack top element, NULL if empty */
+    size_t size;                /* number of elements in stack */
+    stkEl_t *frame;             /* header element of topmost frame, NULL if
+                                   there is none */
 
     /* members for administrative use only */
 
     size_t blkSz;               /* stack block size - number of variable
-                                   wrapper elements allocated together */
-    stkEl_t *freeEls;           /* linked list of free elements */
-    stkEl_t *blkEl;             /* next usable element in most recent block */
-    stkBlk_t *blks;             /* linked list of allocated element blocks */
+                                   wrapper elements allocated together for
+                                   the next block */
+    stkEl_t *cur;               /* next usable element in current block */
+    stkEl_t *base;              /* first element of current block */
+    stkEl_t *end;               /* end of current block */
+    stkBlk_t *blk;              /* current block, the one holding top */
+    stkBlk_t *blks;             /* linked list of allocated element blocks,
+                                   from the bottom one upwards */
+    size_t nBlks;               /* number of allocated blocks */
+    size_t blkBytes;            /* number of bytes allocated for blocks */
+    pool_t *pool;               /* pool of blocks, NULL if malloc'd */
+    size_t nStrs;               /* number of strings held */
+    stkStats_t *stats;          /* statistics, NULL unless collected */
+    struct stkRecycle_t *recycle; /* popped string buffers kept for reuse,
+                                   NULL unless recycling is on */
+    struct stkTune_t *tune;     /* block size tuning, NULL unless on */
+    struct stk_t *LIST_LINK;    /* link to next idle stack in pool */
 
 } stk_t; /* stack */
 
 
+typedef struct
+{
+    stkEl_t *els;               /* first (bottommost) element of run */
+    size_t n;                   /* number of elements in run */
+
+} stkRun_t; /* contiguous run of elements within a block */
+
+
+typedef struct
+{
+    size_t n;                   /* number of elements borrowed */
+    size_t nRuns;               /* number of runs */
+    stkRun_t runs[STK_SPAN_RUNS]; /* runs from the bottom upwards, the
+                                   last one ending at the top */
+
+    /* members for administrative use only */
+
+    size_t nStrs;               /* number of strings borrowed */
+    size_t strBytes;            /* bytes held by them (if STK_STATS) */
+
+} stkSpan_t; /* top elements borrowed in place, see `stkBorrowSpan()` */
+
+
+typedef struct
+{
+    stkEl_t *el;                /* current element, NULL if past the end */
+
+    /* members for administrative use only */
+
+    stkEl_t *first;             /* first element of current block */
+    stkEl_t *last;              /* last used element of current block */
+    stkBlk_t *blk;              /* current block */
+    const stk_t *s;             /* stack iterated over */
+
+} stkIter_t; /* non-destructive stack iterator */
+
+
+/**
+ * maps a contiguous run of elements into a partial result
+ *
+ * @param  els   first (bottommost) element of the run
+ * @param  n     number of elements in the run
+ * @param  part  partial result of the calling worker to accumulate into
+ * @param  arg   user argument given to `stkMapReduce()`
+ */
+typedef void (*stkMapFn_t)(const stkEl_t *els, size_t n, void *part,
+                           void *arg);
+
+
+/**
+ * folds a partial result into the accumulator
+ *
+ * @param  acc   accumulator given to `stkMapReduce()`
+ * @param  part  partial result of a worker
+ * @param  arg   user argument given to `stkMapReduce()`
+ */
+typedef void (*stkReduceFn_t)(void *acc, const void *part, void *arg);
+
+
 /* ----- function signatures ----------------------------------------------- */
 
 
@@ -164,6 +348,22 @@ stkNew(size_t blkSz)
     __attribute__((malloc, warn_unused_result));
 
 
+/**
+ * creates and initializes a new stack taking its blocks from a pool
+ *
+ * Stacks of the same block size can share a pool, so blocks released by
+ * one (on destroy or trim) are reused by the others without malloc().
+ *
+ * @param  pool  pool of blocks, its object size gives the block size (see
+ *               `STK_BLK_BYTES()`); must outlive the stack
+ * @return       new stack on success; NULL if pool objects cannot hold a
+ *               single element, or memory could not be allocated
+ */
+stk_t *
+stkNewPool(pool_t *pool)
+    __attribute__((nonnull(1), malloc, warn_unused_result));
+
+
 /**
  * pushes a variable into stack
  *
@@ -178,26 +378,20 @@ stkNew(size_t blkSz)
  * @warning      for string variables allocates storage and copies a duplicate
  *               into it; allocated space is going to be freed on pop, clear
  *               and destroy
- * @note         intended to be used through `stkPushXxx()` macros
+ * @note         intended to be used through `stkPush()` when the type is
+ *               known only at run time; `stkPushXxx()` macros expand to
+ *               inline functions instead, which call out of line only for
+ *               block allocation and string duplication
  */
 stkEl_t *
 _stkPush(stk_t *s, char type, stkVar_t var)
     __attribute__((nonnull(1)));
 
 
-/**
- * removes the top element from stack and frees possibly allocated
- * resources belonging to it
- *
- * @return  address of new top element after pop; NULL if empty
- */
-stkEl_t *
-stkPop(stk_t *s)
-    __attribute__((nonnull(1)));
-
-
 /**
  * clears stack by popping each element out from the stack
+ *
+ * @note  O(1) if stack holds no strings, as there is nothing to free then
  */
 void
 stkClear(stk_t *s)
@@ -223,4 +417,605 @@ stkValToStr(stk_t *s)
     __attribute__((nonnull(1)));
 
 
+/**
+ * pushes a frame of values into stack in one go
+ *
+ * The frame takes n+1 contiguous elements: a header of type 'f' linking
+ * to the header of the previous frame, then the values from the bottom
+ * up, reached by `stkFrameEl()`. If the rest of the current block cannot
+ * hold them, the frame starts in the next block.
+ *
+ * @param  s      stack
+ * @param  n      number of values, less than the size of the block to
+ *                hold them
+ * @param  types  type of each value ('i'|'d'|'c'|'s'|'p'), see `_stkPush()`
+ * @param  vals   values; NULL to push zeroes (and empty strings)
+ * @return        first value element of frame on success; NULL otherwise
+ */
+stkEl_t *
+stkPushFrame(stk_t *s, size_t n, const char *types, const stkVar_t *vals)
+    __attribute__((nonnull(1, 3)));
+
+
+/**
+ * pops the topmost frame, with everything pushed above it
+ *
+ * @return  address of new top element after pop; NULL if empty
+ * @note    O(1) within a block unless the stack holds strings, for those
+ *          have to be looked for to be freed
+ */
+stkEl_t *
+stkPopFrame(stk_t *s)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * borrows the top elements in place, as a few contiguous runs of block
+ * storage, to be consumed without copying and popped at once by
+ * `stkReleaseSpan()`
+ *
+ * Each run is an array of elements, types and values side by side, in
+ * bottom to top order; runs are given from the bottom upwards too, so
+ * walking them in order visits the elements in push order.
+ *
+ * @param  s     stack; must not be modified until the span is released
+ * @param  n     number of elements to borrow
+ * @param  span  span to fill in
+ * @return       number of elements borrowed; less than n if the stack
+ *               holds fewer, or they lie in more than `STK_SPAN_RUNS`
+ *               blocks (borrow again after release for the rest)
+ * @note         elements may be modified in place, e.g., a string may be
+ *               taken over by changing its type to 'p' (strings are
+ *               counted here, so those no longer being 's' on release are
+ *               known to be taken over); no state is kept in the stack, so
+ *               spans of distinct stacks can be handled at the same time
+ */
+size_t
+stkBorrowSpan(stk_t *s, size_t n, stkSpan_t *span)
+    __attribute__((nonnull(1, 3)));
+
+
+/**
+ * pops the elements of a borrowed span at once
+ *
+ * @param  s     stack the span is borrowed from
+ * @param  span  span got by `stkBorrowSpan()`
+ * @return       address of new top element after pop; NULL if empty
+ * @note         O(1) within a block unless the span holds strings, for
+ *               those have to be looked for to be freed
+ */
+stkEl_t *
+stkReleaseSpan(stk_t *s, const stkSpan_t *span)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * turns on deferred freeing of popped strings
+ *
+ * Popped string buffers are kept on per size class lists of the stack and
+ * are reused by later string pushes of similar length, instead of being
+ * freed one by one. They are freed for real only by `stkTrim()` and
+ * `stkDestroy()`, or on pop when keeping them would exceed the budget.
+ *
+ * @param  s       stack; must hold no strings when recycling is turned on
+ * @param  budget  maximum number of bytes kept in popped buffers; 0 turns
+ *                 recycling off and frees the buffers kept
+ * @return         0 on success; -1 if stack holds strings or memory could
+ *                 not be allocated
+ * @note           buffers are allocated in power of two sizes while
+ *                 recycling is on, so short strings take up to twice the
+ *                 space
+ */
+int
+stkStrRecycle(stk_t *s, size_t budget)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * releases memory kept for reuse: recycled string buffers and spare blocks
+ * above the current one (all blocks if stack is empty)
+ */
+void
+stkTrim(stk_t *s)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * turns on automatic block sizing
+ *
+ * Block size is adjusted from observed usage, affecting blocks allocated
+ * later. Usage is split into episodes, each ending when the stack gets
+ * empty (by pop or clear). Allocating more than one block in an episode
+ * doubles the block size, so deep stacks take O(log depth) allocations.
+ * When the peak depth of the last few episodes fits a quarter of the
+ * block size, the size is lowered to twice that peak; and the emptied
+ * stack releases its blocks if they hold much more than needed, to start
+ * over with the new size.
+ *
+ * @param  s         stack; must not take its blocks from a pool
+ * @param  minBlkSz  smallest block size, at least 1
+ * @param  maxBlkSz  largest block size, bounding the memory and the
+ *                   allocation latency of one block; 0 turns tuning off
+ * @return           0 on success; -1 if arguments are invalid, stack
+ *                   takes its blocks from a pool, or memory could not be
+ *                   allocated
+ * @note             the current block size is clamped into the bounds;
+ *                   the push fast path is not affected, depth is observed
+ *                   in the slow path at doubling watermarks of the block
+ */
+int
+stkTune(stk_t *s, size_t minBlkSz, size_t maxBlkSz)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * gets decisions and observations of automatic block sizing
+ *
+ * @param  s    stack
+ * @param  out  where to put the figures
+ * @return      0 on success; -1 if tuning is off
+ */
+int
+stkTuneStats(const stk_t *s, stkTuneStats_t *out)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * starts iteration at the top element
+ *
+ * @param  s   stack to iterate over; must not be modified while iterating
+ * @param  it  iterator state to initialize
+ * @return     top element; NULL if stack is empty
+ */
+stkEl_t *
+stkIterTop(const stk_t *s, stkIter_t *it)
+    __attribute__((nonnull(1, 2)));
+
+
+/** starts iteration at the bottom element, see `stkIterTop()` */
+stkEl_t *
+stkIterBottom(const stk_t *s, stkIter_t *it)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * aggregates stack contents on several threads
+ *
+ * Elements are split into contiguous runs by blocks, and runs are
+ * distributed among worker threads in bottom to top order. Each worker
+ * maps its runs into a private copy of the accumulator, then the partial
+ * results are reduced into the accumulator in the caller's thread, in
+ * bottom to top order of workers.
+ *
+ * @param  s         stack, must not be modified while mapping
+ * @param  nThreads  number of workers; 0 for one per online processor
+ * @param  map       map function, called concurrently on distinct runs
+ * @param  reduce    reduce function, called sequentially
+ * @param  acc       accumulator; must hold the identity value of the
+ *                   reduction on call, as it is copied into every partial
+ *                   result to start with
+ * @param  accSz     size of accumulator in bytes
+ * @param  arg       user argument passed over to map and reduce
+ * @return           0 on success; -1 if memory could not be allocated
+ * @note             workers that cannot be started are run in the caller's
+ *                   thread, so the result does not depend on thread creation
+ */
+int
+stkMapReduce(const stk_t *s, unsigned nThreads, stkMapFn_t map,
+             stkReduceFn_t reduce, void *acc, size_t accSz, void *arg)
+    __attribute__((nonnull(1, 3, 4, 5)));
+
+
+/**
+ * gets statistics of stack
+ *
+ * Statistics are collected only if the library is built with `STK_STATS`
+ * defined (`./configure --enable-stats`); pushes and pops inlined into
+ * callers are counted only if `STK_STATS` is defined for them as well.
+ * Derived counters (`blkHits`, `bytesReserved`, `bytesLive`) are computed
+ * on call.
+ *
+ * @param  s    stack
+ * @param  out  statistics to fill in
+ * @return      0 on success; -1 if statistics are not collected
+ */
+int
+stkStats(const stk_t *s, stkStats_t *out)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * turns on sampling of push and pop latencies into the histogram of
+ * statistics
+ *
+ * @param  s      stack
+ * @param  every  sampling period, one operation out of this many is timed;
+ *                0 turns sampling off
+ * @return        0 on success; -1 if statistics are not collected
+ * @note          samples include the cost of reading the clock
+ */
+int
+stkStatsSample(stk_t *s, size_t every)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * finds the topmost element holding the given typed value
+ *
+ * @param  s     stack to search in
+ * @param  type  type of value ('i'nteger|'d'ouble|'c'haracter|'s'tring|
+ *               'p'ointer)
+ * @param  var   value to find; strings are compared by content, doubles
+ *               by `==`
+ * @return       address of the matching element; NULL if not found
+ * @note         intended to be used through `stkFindXxx()` macros
+ */
+stkEl_t *
+stkFind(const stk_t *s, char type, stkVar_t var)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * counts elements of given type
+ *
+ * @param  s     stack to search in
+ * @param  type  type of elements to count
+ * @return       number of elements of given type
+ */
+size_t
+stkCountType(const stk_t *s, char type)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * sets SIMD instruction set used by `stkFind()` and `stkCountType()`
+ *
+ * By default the best level supported by the CPU is used (detected via
+ * cpuid on first search); this function is needed only to restrict it.
+ * The level is shared by all stacks and safe to set while other threads
+ * search, those searches using either the old or the new level.
+ *
+ * @param  level  one of `STK_SIMD_XXX` levels, or negative for the best
+ *                supported one
+ * @return        level set, which is lowered to the best supported one if
+ *                higher was requested
+ */
+int
+stkSetSimd(int level);
+
+
+/**
+ * steps up to the next block, allocating it if there is no spare one
+ *
+ * @return  first element of the new current block on success;
+ *          NULL otherwise
+ * @note    slow path of element acquisition, not to be called directly
+ */
+stkEl_t *
+_stkGrow(stk_t *s)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * steps down to the next lower block after its bottom element is popped
+ *
+ * @return  new top element; NULL if stack got empty
+ * @note    slow path of pop, not to be called directly
+ */
+stkEl_t *
+_stkShrink(stk_t *s)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * gets element at given depth below the top of the current block
+ *
+ * @note  slow path of `stkPeek()`, not to be called directly
+ */
+stkEl_t *
+_stkPeekDeep(stk_t *s, size_t n)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * steps iterator to the next lower block
+ *
+ * @note  slow path of `stkIterDown()`, not to be called directly
+ */
+stkEl_t *
+_stkIterDownBlk(stkIter_t *it)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * steps iterator to the next upper block
+ *
+ * @note  slow path of `stkIterUp()`, not to be called directly
+ */
+stkEl_t *
+_stkIterUpBlk(stkIter_t *it)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * duplicates string to be pushed
+ *
+ * @note  slow path of string push, not to be called directly
+ */
+char *
+_stkStrDup(stk_t *s, const char *str)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * frees string duplicate that is popped
+ *
+ * @note  slow path of string pop, not to be called directly
+ */
+void
+_stkStrFree(stk_t *s, char *str)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * reads clock to start a latency sample
+ *
+ * @note  statistics hook, not to be called directly
+ */
+unsigned long long
+_stkStatsClock(void);
+
+
+/**
+ * puts a latency sample into histogram of statistics
+ *
+ * @note  statistics hook, not to be called directly
+ */
+void
+_stkStatsSample(stk_t *s, unsigned long long t0)
+    __attribute__((nonnull(1)));
+
+
+/* ----- inline functions -------------------------------------------------- */
+
+
+#ifdef STK_STATS
+/** starts the measurement of an operation, if it is sampled */
+static inline unsigned long long
+_stkStatsStart(stk_t *s)
+{
+    if(s->stats && s->stats->sampleEvery && --s->stats->sampleIn == 0)
+    {
+        s->stats->sampleIn = s->stats->sampleEvery;
+        return _stkStatsClock();
+    }
+    return 0;
+} /* _stkStatsStart */
+
+
+/** counts a push */
+static inline void
+_stkStatsPush(stk_t *s, unsigned long long t0)
+{
+    if(s->stats)
+    {
+        s->stats->pushes++;
+        if(s->size > s->stats->hwm)
+            s->stats->hwm = s->size;
+        if(t0)
+            _stkStatsSample(s, t0);
+    }
+} /* _stkStatsPush */
+
+
+/** counts a pop */
+static inline void
+_stkStatsPop(stk_t *s, unsigned long long t0)
+{
+    if(s->stats)
+    {
+        s->stats->pops++;
+        if(t0)
+            _stkStatsSample(s, t0);
+    }
+} /* _stkStatsPop */
+#endif /* STK_STATS */
+
+
+/**
+ * takes the next wrapper element above the top and makes it the top
+ *
+ * @return  the new top element (type and value uninitialized) on success;
+ *          NULL if a new block would be needed but cannot be allocated
+ */
+static inline stkEl_t *
+_stkAcquire(stk_t *s)
+{
+#ifdef STK_STATS
+    unsigned long long t0 = _stkStatsStart(s);
+#endif
+
+    /* from current block, or from the next one if it is full */
+    if(s->cur < s->end || _stkGrow(s))
+    {
+        s->size++;
+#ifdef STK_STATS
+        _stkStatsPush(s, t0);
+#endif
+        return s->top = s->cur++;
+    }
+    return NULL;
+} /* _stkAcquire */
+
+
+/**
+ * pushes an integer into stack
+ *
+ * @return  address of the pushed variable's wrapper element on success;
+ *          NULL otherwise
+ * @note    intended to be used through `stkPushInt()`
+ */
+static inline stkEl_t *
+_stkPushInt(stk_t *s, int i)
+{
+    stkEl_t *el;
+
+    if((el = _stkAcquire(s)))
+    {
+        el->type = 'i';
+        el->var.i = i;
+    }
+    return el;
+} /* _stkPushInt */
+
+
+/** pushes a double into stack, see `_stkPushInt()` */
+static inline stkEl_t *
+_stkPushDbl(stk_t *s, double d)
+{
+    stkEl_t *el;
+
+    if((el = _stkAcquire(s)))
+    {
+        el->type = 'd';
+        el->var.d = d;
+    }
+    return el;
+} /* _stkPushDbl */
+
+
+/** pushes a character into stack, see `_stkPushInt()` */
+static inline stkEl_t *
+_stkPushChr(stk_t *s, char c)
+{
+    stkEl_t *el;
+
+    if((el = _stkAcquire(s)))
+    {
+        el->type = 'c';
+        el->var.c = c;
+    }
+    return el;
+} /* _stkPushChr */
+
+
+/** pushes a pointer into stack, see `_stkPushInt()` */
+static inline stkEl_t *
+_stkPushPtr(stk_t *s, void *p)
+{
+    stkEl_t *el;
+
+    if((el = _stkAcquire(s)))
+    {
+        el->type = 'p';
+        el->var.p = p;
+    }
+    return el;
+} /* _stkPushPtr */
+
+
+/**
+ * pushes a copy of a string into stack, see `_stkPushInt()`
+ *
+ * @warning  allocates storage for the duplicate; it is freed on pop, clear
+ *           and destroy
+ */
+static inline stkEl_t *
+_stkPushStr(stk_t *s, const char *str)
+{
+    stkEl_t *el;
+    char *dup;
+
+    if((dup = _stkStrDup(s, str)) == NULL)
+        return NULL;
+    if((el = _stkAcquire(s)) == NULL)
+    {
+        _stkStrFree(s, dup);
+        return NULL;
+    }
+    el->type = 's';
+    el->var.s = dup;
+    return el;
+} /* _stkPushStr */
+
+
+/**
+ * removes the top element from stack and frees possibly allocated
+ * resources belonging to it
+ *
+ * @return  address of new top element after pop; NULL if empty
+ */
+static inline stkEl_t *
+stkPop(stk_t *s)
+{
+    stkEl_t *el;
+#ifdef STK_STATS
+    unsigned long long t0 = _stkStatsStart(s);
+#endif
+
+    if((el = s->top))
+    {
+        if(el->type == 's')
+            _stkStrFree(s, el->var.s);
+        else if(el->type == 'f')
+            s->frame = (stkEl_t *)el->var.p;
+        s->size--;
+        s->cur = el;
+        s->top = el > s->base ? el - 1 : _stkShrink(s);
+#ifdef STK_STATS
+        _stkStatsPop(s, t0);
+#endif
+    }
+    return s->top;
+} /* stkPop */
+
+
+/**
+ * gets the element at given depth in stack without removing anything
+ *
+ * @param  n  depth of element, counted from the top (0 for the top one)
+ * @return    address of element; NULL if stack holds no more than n
+ *            elements
+ * @note      O(1) within the current block, O(n/blkSz) below it
+ */
+static inline stkEl_t *
+stkPeek(stk_t *s, size_t n)
+{
+    if(n >= s->size)
+        return NULL;
+    if(n <= (size_t)(s->top - s->base))
+        return s->top - n;
+    return _stkPeekDeep(s, n - (size_t)(s->top - s->base) - 1);
+} /* stkPeek */
+
+
+/**
+ * steps iterator one element down, towards the bottom
+ *
+ * @return  the next element; NULL if there is no more
+ */
+static inline stkEl_t *
+stkIterDown(stkIter_t *it)
+{
+    if(it->el > it->first)
+        return --it->el;
+    return _stkIterDownBlk(it);
+} /* stkIterDown */
+
+
+/** steps iterator one element up, towards the top, see `stkIterDown()` */
+static inline stkEl_t *
+stkIterUp(stkIter_t *it)
+{
+    if(it->el < it->last)
+        return ++it->el;
+    return _stkIterUpBlk(it);
+} /* stkIterUp */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
 #endif /* __STK_H */
@@ -0,0 +1,415 @@
+/**
+ * @file     stk.hpp
+ * @brief    header-only C++ template facade over the expanding stack
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Typed, move-aware wrapper of `stk_t` (stk.h) for C++ callers. Values of
+ * trivially copyable types that fit into `stkVar_t` are stored right in the
+ * wrapper elements of the underlying stack. Any other type (e.g.,
+ * std::string or move-only types) is constructed in place into a slot taken
+ * from a block allocated, free-list recycled slot store, and the stack only
+ * holds the slot's address - so values are moved in and out without
+ * redundant copies or per element allocations.
+ *
+ * Usage example:
+ *
+ *        stk::stack<std::string> s(128);
+ *        s.emplace(10, 'x');
+ *        s.push(std::move(str));
+ *        for(auto &v : s)
+ *            std::cout << v << std::endl;
+ *        std::string top = s.pop_value();
+ */
+
+
+#ifndef __STK_HPP
+#define __STK_HPP
+
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "stk.h"
+
+
+namespace stk {
+
+
+namespace detail {
+
+
+/**
+ * block allocated store of uninitialized slots for values of type T,
+ * recycling released slots through a free list
+ */
+template<typename T>
+class slots
+{
+public:
+    explicit slots(std::size_t blkSz) noexcept
+        : blkSz_(blkSz ? blkSz : 1) { }
+
+    slots(slots &&o) noexcept
+        : blkSz_(o.blkSz_), free_(o.free_), blkSlot_(o.blkSlot_),
+          blkEnd_(o.blkEnd_), blks_(o.blks_)
+    {
+        o.free_ = nullptr;
+        o.blkSlot_ = o.blkEnd_ = nullptr;
+        o.blks_ = nullptr;
+    }
+
+    slots(const slots &) = delete;
+    slots &operator=(const slots &) = delete;
+
+    void swap(slots &o) noexcept
+    {
+        std::swap(blkSz_, o.blkSz_);
+        std::swap(free_, o.free_);
+        std::swap(blkSlot_, o.blkSlot_);
+        std::swap(blkEnd_, o.blkEnd_);
+        std::swap(blks_, o.blks_);
+    }
+
+    ~slots()
+    {
+        blk *b, *tmp;
+
+        listForEachSafe(b, tmp, blks_)
+            ::operator delete(b);
+    }
+
+    /** gets an uninitialized slot; throws std::bad_alloc on failure */
+    void *acquire()
+    {
+        slot *sl;
+
+        if(free_)
+        {
+            /* from linked list of free ones */
+            sl = free_;
+            free_ = free_->next;
+        }
+        else if(blkSlot_ < blkEnd_)
+        {
+            /* from already allocated block */
+            sl = blkSlot_++;
+        }
+        else
+        {
+            /* allocate new block */
+            blk *b = static_cast<blk *>(
+                ::operator new(sizeof(blk) + sizeof(slot) * blkSz_));
+            b->LIST_LINK = blks_;
+            blks_ = b;
+            blkSlot_ = reinterpret_cast<slot *>(b + 1);
+            blkEnd_ = blkSlot_ + blkSz_;
+
+            /* from just allocated block */
+            sl = blkSlot_++;
+        }
+        return sl;
+    }
+
+    /** gives back a slot the value in which has already been destroyed */
+    void release(void *p) noexcept
+    {
+        slot *sl = static_cast<slot *>(p);
+
+        sl->next = free_;
+        free_ = sl;
+    }
+
+private:
+    union slot
+    {
+        alignas(T) unsigned char obj[sizeof(T)];
+        slot *next;
+    };
+
+    struct alignas(alignof(slot) > alignof(void *) ?
+                   alignof(slot) : alignof(void *)) blk
+    {
+        blk *LIST_LINK;
+    };
+
+    std::size_t blkSz_;
+    slot *free_ = nullptr;
+    slot *blkSlot_ = nullptr;
+    slot *blkEnd_ = nullptr;
+    blk *blks_ = nullptr;
+};
+
+
+/** tells whether values of T are kept right in the wrapper elements */
+template<typename T>
+constexpr bool isInline =
+    std::is_trivially_copyable_v<T> &&
+    sizeof(T) <= sizeof(stkVar_t) &&
+    alignof(T) <= alignof(stkVar_t);
+
+
+/** type tag of the wrapper element holding a T */
+template<typename T>
+constexpr char tag()
+{
+    if constexpr(std::is_same_v<T, int>)
+        return 'i';
+    else if constexpr(std::is_same_v<T, double>)
+        return 'd';
+    else if constexpr(std::is_same_v<T, char>)
+        return 'c';
+    else
+        return 'p'; /* pointer, raw bytes or slot address */
+}
+
+
+/** empty placeholder of slot store for inline stored types */
+struct noSlots
+{
+    explicit noSlots(std::size_t) noexcept { }
+    void swap(noSlots &) noexcept { }
+};
+
+
+} /* namespace detail */
+
+
+/**
+ * LIFO container of T values on top of `stk_t`
+ *
+ * @warning  not copyable; the underlying `stk_t` must not be pushed or
+ *           popped through the C API while held by the container
+ */
+template<typename T>
+class stack
+{
+    static constexpr bool inl = detail::isInline<T>;
+
+    using slots_t = std::conditional_t<inl, detail::noSlots, detail::slots<T>>;
+
+public:
+    using value_type      = T;
+    using reference       = T &;
+    using const_reference = const T &;
+    using size_type       = std::size_t;
+
+    /** forward iterator visiting values from top to bottom */
+    template<bool Const>
+    class iter
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<Const, const T *, T *>;
+        using reference         = std::conditional_t<Const, const T &, T &>;
+
+        iter() noexcept { it_.el = nullptr; }
+        explicit iter(const stk_t *s) noexcept
+        {
+            if(s)
+                stkIterTop(s, &it_);
+            else
+                it_.el = nullptr;
+        }
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        iter(const iter<false> &o) noexcept : it_(o.it_) { }
+
+        reference operator*() const noexcept { return *stack::val(it_.el); }
+        pointer operator->() const noexcept { return stack::val(it_.el); }
+        iter &operator++() noexcept { stkIterDown(&it_); return *this; }
+        iter operator++(int) noexcept { iter i = *this; ++*this; return i; }
+        bool operator==(const iter &o) const noexcept
+            { return it_.el == o.it_.el; }
+        bool operator!=(const iter &o) const noexcept
+            { return it_.el != o.it_.el; }
+
+    private:
+        template<bool> friend class iter;
+        stkIter_t it_;
+    };
+
+    using iterator       = iter<false>;
+    using const_iterator = iter<true>;
+
+    /**
+     * @param  blkSz  block size of the underlying stack (and of the slot
+     *                store, if any)
+     * @throw  std::bad_alloc if the stack cannot be created
+     */
+    explicit stack(size_type blkSz = 128)
+        : s_(stkNew(blkSz)), blkSz_(blkSz), slots_(blkSz)
+    {
+        if(s_ == nullptr)
+            throw std::bad_alloc();
+    }
+
+    /** leaves o empty, its stack created again on its next push */
+    stack(stack &&o) noexcept
+        : s_(o.s_), blkSz_(o.blkSz_), slots_(std::move(o.slots_))
+    {
+        o.s_ = nullptr;
+    }
+
+    stack &operator=(stack &&o) noexcept
+    {
+        stack tmp(std::move(o));
+
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(stack &o) noexcept
+    {
+        std::swap(s_, o.s_);
+        std::swap(blkSz_, o.blkSz_);
+        slots_.swap(o.slots_);
+    }
+
+    stack(const stack &) = delete;
+    stack &operator=(const stack &) = delete;
+
+    ~stack()
+    {
+        if(s_)
+        {
+            clear();
+            stkDestroy(s_);
+        }
+    }
+
+    bool empty() const noexcept { return s_ == nullptr || stkIsEmpty(s_); }
+    size_type size() const noexcept { return s_ ? stkSize(s_) : 0; }
+
+    /** top value, use only if !empty() */
+    reference top() noexcept { return *val(s_->top); }
+    const_reference top() const noexcept { return *val(s_->top); }
+
+    /**
+     * constructs a new value in place on top of the stack
+     *
+     * @throw  std::bad_alloc, or whatever the constructor of T throws
+     */
+    template<typename... Args>
+    reference emplace(Args &&...args)
+    {
+        stkEl_t *el;
+
+        /* moved from, stack created again */
+        if(s_ == nullptr && (s_ = stkNew(blkSz_)) == nullptr)
+            throw std::bad_alloc();
+
+        if constexpr(inl)
+        {
+            if((el = _stkAcquire(s_)) == nullptr)
+                throw std::bad_alloc();
+            el->type = detail::tag<T>();
+            try
+            {
+                new(&el->var) T(std::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                stkPop(s_);     /* slot taken back, nothing to destroy */
+                throw;
+            }
+        }
+        else
+        {
+            void *p = slots_.acquire();
+
+            try
+            {
+                new(p) T(std::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                slots_.release(p);
+                throw;
+            }
+            if((el = _stkPushPtr(s_, p)) == nullptr)
+            {
+                static_cast<T *>(p)->~T();
+                slots_.release(p);
+                throw std::bad_alloc();
+            }
+        }
+        return *val(el);
+    }
+
+    void push(const T &v) { emplace(v); }
+    void push(T &&v) { emplace(std::move(v)); }
+
+    /** removes the top value, use only if !empty() */
+    void pop() noexcept
+    {
+        if constexpr(!inl)
+        {
+            T *p = val(s_->top);
+
+            p->~T();
+            slots_.release(p);
+        }
+        stkPop(s_);
+    }
+
+    /** moves the top value out and removes it, use only if !empty() */
+    T pop_value()
+    {
+        T v(std::move(top()));
+
+        pop();
+        return v;
+    }
+
+    /** removes every value */
+    void clear() noexcept
+    {
+        if constexpr(inl)
+        {
+            if(s_)
+                stkClear(s_);
+        }
+        else
+        {
+            while(!empty())
+                pop();
+        }
+    }
+
+    iterator begin() noexcept { return iterator(s_); }
+    iterator end() noexcept { return iterator(); }
+    const_iterator begin() const noexcept { return const_iterator(s_); }
+    const_iterator end() const noexcept { return const_iterator(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    /** underlying stack, for read-only use through the C API; NULL if
+        moved from and not pushed to since */
+    stk_t *get() const noexcept { return s_; }
+
+private:
+    static T *val(stkEl_t *el) noexcept
+    {
+        if constexpr(inl)
+            return std::launder(reinterpret_cast<T *>(&el->var));
+        else
+            return static_cast<T *>(el->var.p);
+    }
+
+    stk_t *s_;
+    size_type blkSz_;
+    slots_t slots_;
+};
+
+
+} /* namespace stk */
+
+
+#endif /* __STK_HPP */
@@ -0,0 +1,336 @@
+/**
+ * @file     stkfind.c
+ * @brief    search and count over expanding stack contents
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Elements are scanned run by run (a run being the contiguous used part
+ * of a block) with SSE2 or AVX2 kernels on x86, chosen at run time by
+ * cpuid, or with scalar loops elsewhere.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+/* kernels rely on the LP64 element layout: value in bytes 0-7, type in
+   byte 8, 16 bytes per element */
+#if defined(__x86_64__) && defined(__GNUC__)
+#  define STK_X86 1
+#  include <immintrin.h>
+#endif
+
+#include "stk.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** offset of type tag within wrapper element */
+#define TYPE_OFS  offsetof(stkEl_t, type)
+
+
+/* ----- globals ----------------------------------------------------------- */
+
+
+/** SIMD level in use, negative until detected; accessed atomically, as
+ *  searches of different stacks may run in parallel */
+static int _simdLevel = -1;
+
+
+/* ----- function definitions ---------------------------------------------- */
+
+
+/** tests whether an element holds the given typed value */
+static int
+elEq(const stkEl_t *el, char type, stkVar_t var)
+{
+    if(el->type != type)
+        return 0;
+    switch(type)
+    {
+        case 'i': return el->var.i == var.i;
+        case 'd': return el->var.d == var.d;
+        case 'c': return el->var.c == var.c;
+        case 'p': return el->var.p == var.p;
+        case 's': return strcmp(el->var.s, var.s) == 0;
+        default: return 0;
+    }
+} /* elEq */
+
+
+/** finds last matching element of a run, scalar version */
+static const stkEl_t *
+findScalar(const stkEl_t *els, size_t n, char type, stkVar_t var)
+{
+    while(n--)
+        if(elEq(&els[n], type, var))
+            return &els[n];
+    return NULL;
+} /* findScalar */
+
+
+/** counts elements of a type in a run, scalar version */
+static size_t
+countScalar(const stkEl_t *els, size_t n, char type)
+{
+    size_t cnt = 0;
+
+    while(n--)
+        cnt += els[n].type == type;
+    return cnt;
+} /* countScalar */
+
+
+#ifdef STK_X86
+
+
+/** tests whether an element loaded holds the value of pattern, SSE2 */
+__attribute__((target("sse2")))
+static inline int
+matchSse2(__m128i x, __m128i pv, unsigned need, int dbl)
+{
+    unsigned m = _mm_movemask_epi8(_mm_cmpeq_epi8(x, pv));
+
+    /* doubles compared as such, only in the low lane holding the value */
+    if(dbl)
+        m = (m & 1u << TYPE_OFS) | (_mm_movemask_pd(_mm_cmpeq_pd(
+                _mm_castsi128_pd(x), _mm_castsi128_pd(pv))) & 1 ? 0xff : 0);
+    return (m & need) == need;
+} /* matchSse2 */
+
+
+/** finds last matching element of a run, SSE2 version (four elements
+ *  of a vector each per round) */
+__attribute__((target("sse2")))
+static const stkEl_t *
+findSse2(const stkEl_t *els, size_t n, char type, stkVar_t var)
+{
+    long long bits = 0;
+    unsigned need = 1u << TYPE_OFS; /* compare mask bits of a match */
+    __m128i pv;                     /* pattern of value and type tag */
+    size_t i;
+
+    switch(type)
+    {
+        case 'i': need |= 0x000f; break;
+        case 'c': need |= 0x0001; break;
+        case 'd':
+        case 'p': need |= 0x00ff; break;
+        default: return findScalar(els, n, type, var);
+    }
+    memcpy(&bits, &var, sizeof(var));
+    pv = _mm_set_epi64x((unsigned char)type, bits);
+
+    /* odd ones at the top end first */
+    for(; n % 4; n--)
+        if(elEq(&els[n-1], type, var))
+            return &els[n-1];
+
+    while(n)
+    {
+        n -= 4;
+        if(matchSse2(_mm_loadu_si128((const __m128i *)&els[n]), pv, need,
+                     type == 'd') |
+           matchSse2(_mm_loadu_si128((const __m128i *)&els[n+1]), pv, need,
+                     type == 'd') |
+           matchSse2(_mm_loadu_si128((const __m128i *)&els[n+2]), pv, need,
+                     type == 'd') |
+           matchSse2(_mm_loadu_si128((const __m128i *)&els[n+3]), pv, need,
+                     type == 'd'))
+            for(i = 4; i--; )
+                if(elEq(&els[n+i], type, var))
+                    return &els[n+i];
+    }
+    return NULL;
+} /* findSse2 */
+
+
+/** counts elements of a type in a run, SSE2 version (four elements of a
+ *  vector each per round, matches summed up by bytes) */
+__attribute__((target("sse2")))
+static size_t
+countSse2(const stkEl_t *els, size_t n, char type)
+{
+    const __m128i tv = _mm_set1_epi8(type);
+    const __m128i mask = _mm_set_epi64x(0xff, 0); /* type byte */
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0, end;
+
+    while(i + 4 <= n)
+    {
+        /* byte counters taking at most 4 a round, flushed before 255 */
+        __m128i cnt = _mm_setzero_si128();
+
+        for(end = i + 252 < n ? i + 252 : n; i + 4 <= end; i += 4)
+        {
+            cnt = _mm_sub_epi8(cnt, _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i *)&els[i]), tv));
+            cnt = _mm_sub_epi8(cnt, _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i *)&els[i+1]), tv));
+            cnt = _mm_sub_epi8(cnt, _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i *)&els[i+2]), tv));
+            cnt = _mm_sub_epi8(cnt, _mm_cmpeq_epi8(
+                _mm_loadu_si128((const __m128i *)&els[i+3]), tv));
+        }
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_and_si128(cnt, mask),
+                                              _mm_setzero_si128()));
+    }
+    return _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)) +
+           countScalar(els + i, n - i, type);
+} /* countSse2 */
+
+
+/** finds last matching element of a run, AVX2 version (two per vector) */
+__attribute__((target("avx2")))
+static const stkEl_t *
+findAvx2(const stkEl_t *els, size_t n, char type, stkVar_t var)
+{
+    const __m256i tv = _mm256_set1_epi8(type);
+    /* value compare mask bits of element 0 and 1 (low and high lane) */
+    const unsigned both = 0x00010001u;
+    __m256i vv;
+
+    switch(type)
+    {
+        case 'i': vv = _mm256_set1_epi32(var.i); break;
+        case 'd': vv = _mm256_castpd_si256(_mm256_set1_pd(var.d)); break;
+        case 'c': vv = _mm256_set1_epi8(var.c); break;
+        case 'p': vv = _mm256_set1_epi64x((long long)var.p); break;
+        default: return findScalar(els, n, type, var);
+    }
+
+    /* odd one at the top end first */
+    if(n % 2 && elEq(&els[n-1], type, var))
+        return &els[n-1];
+    n -= n % 2;
+
+    while(n)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&els[n -= 2]);
+        unsigned tm = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, tv));
+        unsigned vm;
+
+        switch(type)
+        {
+            case 'i': vm = _mm256_movemask_epi8(_mm256_cmpeq_epi32(x, vv));
+                      break;
+            case 'd': vm = _mm256_movemask_epi8(_mm256_castpd_si256(
+                          _mm256_cmp_pd(_mm256_castsi256_pd(x),
+                                        _mm256_castsi256_pd(vv),
+                                        _CMP_EQ_OQ)));
+                      break;
+            case 'c': vm = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, vv));
+                      break;
+            default:  vm = _mm256_movemask_epi8(_mm256_cmpeq_epi64(x, vv));
+                      break;
+        }
+        if((vm &= (tm >> TYPE_OFS) & both))
+            return &els[vm >> 16 ? n + 1 : n];
+    }
+    return NULL;
+} /* findAvx2 */
+
+
+/** counts elements of a type in a run, AVX2 version */
+__attribute__((target("avx2")))
+static size_t
+countAvx2(const stkEl_t *els, size_t n, char type)
+{
+    const __m256i tv = _mm256_set1_epi8(type);
+    const __m256i one = _mm256_set_epi64x(1, 0, 1, 0); /* 1 at type bytes */
+    __m256i acc = _mm256_setzero_si256();
+    size_t i, cnt;
+
+    for(i = 0; i + 2 <= n; i += 2)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&els[i]);
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(x, tv), one),
+            _mm256_setzero_si256()));
+    }
+    cnt = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+          _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+    return cnt + countScalar(els + i, n - i, type);
+} /* countAvx2 */
+
+
+#endif /* STK_X86 */
+
+
+int
+stkSetSimd(int level)
+{
+    int max = STK_SIMD_NONE;
+
+#ifdef STK_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        max = STK_SIMD_AVX2;
+    else if(__builtin_cpu_supports("sse2"))
+        max = STK_SIMD_SSE2;
+#endif
+
+    level = level < 0 || level > max ? max : level;
+    __atomic_store_n(&_simdLevel, level, __ATOMIC_RELAXED);
+    return level;
+} /* stkSetSimd */
+
+
+/** gets SIMD level in use, detecting it first if not yet done; threads
+ *  racing here detect and store the same level */
+static int
+simdLevel(void)
+{
+    int level = __atomic_load_n(&_simdLevel, __ATOMIC_RELAXED);
+
+    return level < 0 ? stkSetSimd(-1) : level;
+} /* simdLevel */
+
+
+stkEl_t *
+stkFind(const stk_t *s, char type, stkVar_t var)
+{
+    const stkEl_t *(*find)(const stkEl_t *, size_t, char, stkVar_t);
+    const stkEl_t *el = NULL;
+    stkIter_t it;
+
+    switch(simdLevel())
+    {
+#ifdef STK_X86
+        case STK_SIMD_AVX2: find = findAvx2; break;
+        case STK_SIMD_SSE2: find = findSse2; break;
+#endif
+        default: find = findScalar; break;
+    }
+
+    /* from the top run downwards */
+    for(stkIterTop(s, &it); it.el && el == NULL; _stkIterDownBlk(&it))
+        el = find(it.first, it.last - it.first + 1, type, var);
+
+    return (stkEl_t *)el;
+} /* stkFind */
+
+
+size_t
+stkCountType(const stk_t *s, char type)
+{
+    size_t (*count)(const stkEl_t *, size_t, char);
+    size_t cnt = 0;
+    stkIter_t it;
+
+    switch(simdLevel())
+    {
+#ifdef STK_X86
+        case STK_SIMD_AVX2: count = countAvx2; break;
+        case STK_SIMD_SSE2: count = countSse2; break;
+#endif
+        default: count = countScalar; break;
+    }
+
+    for(stkIterTop(s, &it); it.el; _stkIterDownBlk(&it))
+        cnt += count(it.first, it.last - it.first + 1, type);
+
+    return cnt;
+} /* stkCountType */
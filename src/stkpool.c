@@ -0,0 +1,203 @@
+/**
+ * @file     stkpool.c
+ * @brief    pool of expanding stacks for reuse
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "stkpool.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** compares pointers for list searches */
+#define PTRCMP(a, b)  ((a) != (b))
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct stkPoolCache_t stkPoolCache_t;
+struct stkPoolCache_t
+{
+    stkPool_t *pool;            /* pool cached for */
+    stk_t *stks;                /* list of idle stacks */
+    size_t n;                   /* number of idle stacks */
+    stkPoolCache_t *LIST_LINK;  /* link to next cache of pool */
+
+}; /* idle stacks cached by a thread */
+
+
+struct stkPool_t
+{
+    size_t blkSz;               /* block size of stacks */
+    size_t maxBytes;            /* maximum number of bytes retained */
+    size_t bytes;               /* number of bytes retained (atomic) */
+    stk_t *idle;                /* list of idle stacks shared by threads */
+    stkPoolCache_t *caches;     /* list of thread caches */
+    pthread_key_t key;          /* key of thread cache */
+    pthread_mutex_t lock;       /* lock of shared lists */
+
+}; /* pool of stacks */
+
+
+/* ----- function definitions ---------------------------------------------- */
+
+
+/** gets number of bytes retained by an idle stack */
+static size_t
+stkBytes(const stk_t *s)
+{
+    return sizeof(*s) + s->blkBytes;
+} /* stkBytes */
+
+
+/** hands idle stacks of an exiting thread over to the shared list */
+static void
+cacheFree(void *arg)
+{
+    stkPoolCache_t *c = arg;
+    stkPool_t *pool = c->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    while(listMove(pool->idle, c->stks))
+        ;
+    listDelMatch(pool->caches,, PTRCMP, , c);
+    pthread_mutex_unlock(&pool->lock);
+    free(c);
+} /* cacheFree */
+
+
+/** gets cache of calling thread, creating it on first use */
+static stkPoolCache_t *
+cacheGet(stkPool_t *pool)
+{
+    stkPoolCache_t *c;
+
+    if((c = pthread_getspecific(pool->key)) == NULL &&
+       (c = calloc(1, sizeof(*c))))
+    {
+        if(pthread_setspecific(pool->key, c))
+        {
+            free(c);
+            return NULL;
+        }
+        c->pool = pool;
+        pthread_mutex_lock(&pool->lock);
+        listAdd(c, pool->caches);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return c;
+} /* cacheGet */
+
+
+stkPool_t *
+stkPoolNew(size_t blkSz, size_t maxBytes)
+{
+    stkPool_t *pool;
+
+    if((pool = calloc(1, sizeof(*pool))) == NULL)
+        return NULL;
+    if(pthread_key_create(&pool->key, cacheFree))
+    {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->blkSz = blkSz;
+    pool->maxBytes = maxBytes;
+    return pool;
+} /* stkPoolNew */
+
+
+stk_t *
+stkPoolGet(stkPool_t *pool)
+{
+    stkPoolCache_t *c = cacheGet(pool);
+    stk_t *s = NULL;
+
+    /* from own cache, then from the shared list */
+    if(c && (s = c->stks))
+    {
+        listDel(c->stks);
+        c->n--;
+    }
+    else
+    {
+        pthread_mutex_lock(&pool->lock);
+        if((s = pool->idle))
+            listDel(pool->idle);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    if(s == NULL)
+        return stkNew(pool->blkSz);
+    __atomic_sub_fetch(&pool->bytes, stkBytes(s), __ATOMIC_RELAXED);
+    return s;
+} /* stkPoolGet */
+
+
+void
+stkPoolPut(stkPool_t *pool, stk_t *s)
+{
+    stkPoolCache_t *c;
+    size_t bytes = stkBytes(s);
+
+    if(__atomic_add_fetch(&pool->bytes, bytes, __ATOMIC_RELAXED) >
+       pool->maxBytes)
+    {
+        __atomic_sub_fetch(&pool->bytes, bytes, __ATOMIC_RELAXED);
+        stkDestroy(s);
+        return;
+    }
+
+    /* as good as new, but with its blocks; tuning may have let block size
+       drift from the pool's */
+    stkClear(s);
+    stkStrRecycle(s, 0);
+    stkTune(s, 0, 0);
+    s->blkSz = pool->blkSz;
+#ifdef STK_STATS
+    if(s->stats)
+        memset(s->stats, 0, sizeof(*s->stats));
+#endif
+
+    if((c = cacheGet(pool)) && c->n < STK_POOL_CACHE)
+    {
+        listAdd(s, c->stks);
+        c->n++;
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    listAdd(s, pool->idle);
+    pthread_mutex_unlock(&pool->lock);
+} /* stkPoolPut */
+
+
+void
+stkPoolDestroy(stkPool_t *pool)
+{
+    stkPoolCache_t *c, *tmpC;
+    stk_t *s, *tmpS;
+
+    /* no more cache handover on thread exit */
+    pthread_key_delete(pool->key);
+
+    listForEachSafe(c, tmpC, pool->caches)
+    {
+        listForEachSafe(s, tmpS, c->stks)
+            stkDestroy(s);
+        free(c);
+    }
+    listForEachSafe(s, tmpS, pool->idle)
+        stkDestroy(s);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+} /* stkPoolDestroy */
@@ -0,0 +1,117 @@
+/**
+ * @file     stkpool.h
+ * @brief    pool of expanding stacks for reuse
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Stacks released into a pool are kept with their blocks allocated, and
+ * are handed out again instead of creating new ones, so a stack of a warm
+ * pool costs no allocation at all. Idle stacks are cached per thread
+ * first, then on a list shared by the threads; the memory they retain is
+ * capped.
+ *
+ * Usage example:
+ *
+ *        stkPool_t *pool = stkPoolNew(128, 1 << 20);
+ *        ...
+ *        stk_t *s = stkPoolGet(pool);     (per request)
+ *        stkPushInt(s, 10);
+ *        stkPoolPut(pool, s);
+ *        ...
+ *        stkPoolDestroy(pool);
+ */
+
+
+#ifndef __STKPOOL_H
+#define __STKPOOL_H
+
+
+#include <stddef.h>
+
+#include "stk.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of idle stacks cached per thread before sharing them */
+#define STK_POOL_CACHE 8
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct stkPool_t stkPool_t; /* pool of stacks, opaque */
+
+
+/* ----- function signatures ----------------------------------------------- */
+
+
+/**
+ * creates a new pool of stacks
+ *
+ * @param  blkSz     block size of stacks in pool, see `stkNew()`
+ * @param  maxBytes  maximum number of bytes retained by idle stacks
+ *                   (stack structures and their blocks); stacks released
+ *                   above it are destroyed
+ * @return           new pool on success; NULL otherwise
+ */
+stkPool_t *
+stkPoolNew(size_t blkSz, size_t maxBytes)
+    __attribute__((malloc, warn_unused_result));
+
+
+/**
+ * gets an empty stack from pool, creating a new one only if there is no
+ * idle one
+ *
+ * @return  stack on success; NULL otherwise
+ * @note    stacks cached by the calling thread are taken without locking
+ */
+stk_t *
+stkPoolGet(stkPool_t *pool)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * releases a stack into pool, clearing it
+ *
+ * The stack is reset to the state of a new one (string recycling and
+ * block size tuning off, block size of the pool, statistics zeroed), but
+ * keeps its blocks.
+ *
+ * @param  pool  pool the stack is got from
+ * @param  s     stack got by `stkPoolGet()` of the same pool, not to be
+ *               used by the caller afterwards
+ * @warning      stacks created otherwise, e.g., by `stkNewPool()`, must
+ *               not be put into a pool
+ * @note         clearing is O(1) unless the stack holds strings
+ */
+void
+stkPoolPut(stkPool_t *pool, stk_t *s)
+    __attribute__((nonnull(1, 2)));
+
+
+/**
+ * destroys pool and every idle stack in it
+ *
+ * @warning  stacks got and not yet released are not destroyed; no other
+ *           thread may use the pool meanwhile
+ */
+void
+stkPoolDestroy(stkPool_t *pool)
+    __attribute__((nonnull(1)));
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __STKPOOL_H */
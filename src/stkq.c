@@ -0,0 +1,373 @@
+/**
+ * @file     stkq.c
+ * @brief    queue (first in - first out list) and double-ended queue
+ *           companions of the expanding stack
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "stkq.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** gets first element of a block */
+#define BLK_FIRST(blk)  ((stkEl_t *)((blk) + 1))
+
+
+/* ----- function definitions ---------------------------------------------- */
+
+
+/** copies string of a variable to be pushed; checks type */
+static int
+varDup(char type, stkVar_t *var)
+{
+    switch(type)
+    {
+        case 'i': case 'd': case 'c': case 'p':
+            return 0;
+        case 's':
+            return (var->s = strdup(var->s)) ? 0 : -1;
+        default:
+            return -1;
+    }
+} /* varDup */
+
+
+/** takes a recycled block, or allocates one */
+static stkBlk_t *
+blkGet(stkBlk_t **spare, size_t blkSz, int spsc)
+{
+    stkBlk_t *blk;
+
+    if(spsc)
+        blk = __atomic_exchange_n(spare, NULL, __ATOMIC_ACQUIRE);
+    else if((blk = *spare))
+        listDel(*spare);
+
+    if(blk == NULL)
+        blk = malloc(STK_BLK_BYTES(blkSz));
+    return blk;
+} /* blkGet */
+
+
+/** recycles an emptied block */
+static void
+blkPut(stkBlk_t **spare, stkBlk_t *blk, int spsc)
+{
+    if(spsc)
+        free(__atomic_exchange_n(spare, blk, __ATOMIC_ACQ_REL));
+    else
+        listAdd(blk, *spare);
+} /* blkPut */
+
+
+/** frees list of blocks */
+static void
+blkFreeAll(stkBlk_t *blks)
+{
+    stkBlk_t *blk, *tmpBlk;
+
+    listForEachSafe(blk, tmpBlk, blks)
+        free(blk);
+} /* blkFreeAll */
+
+
+stkq_t *
+stkqNew(size_t blkSz, int flags)
+{
+    stkq_t *q;
+
+    /* aligned, for its ends to be on cache lines of their own */
+    if(blkSz == 0 || (q = aligned_alloc(STKQ_LINE, sizeof(*q))) == NULL)
+        return NULL;
+    memset(q, 0, sizeof(*q));
+    q->blkSz = blkSz;
+    q->spsc = flags & STKQ_SPSC;
+
+    /* ends always have a block, so they never have to agree on the first */
+    if((q->hblk = q->tblk = blkGet(&q->spare, blkSz, 0)) == NULL)
+    {
+        free(q);
+        return NULL;
+    }
+    q->hblk->LIST_LINK = NULL;
+    q->head = q->tail = BLK_FIRST(q->hblk);
+    return q;
+} /* stkqNew */
+
+
+stkEl_t *
+_stkqPush(stkq_t *q, char type, stkVar_t var)
+{
+    stkEl_t *el;
+    stkBlk_t *blk;
+
+    if(varDup(type, &var))
+        return NULL;
+
+    /* tail block full, link a new one after it */
+    if(q->tail == BLK_FIRST(q->tblk) + q->blkSz)
+    {
+        if((blk = blkGet(&q->spare, q->blkSz, q->spsc)) == NULL)
+        {
+            if(type == 's')
+                free(var.s);
+            return NULL;
+        }
+        blk->LIST_LINK = NULL;
+        q->tblk->LIST_LINK = blk;
+        q->tblk = blk;
+        q->tail = BLK_FIRST(blk);
+    }
+
+    el = q->tail++;
+    el->type = type;
+    el->var = var;
+
+    /* publishes element (and link of its block) to the consumer, only
+       the producer writing the count */
+    if(q->spsc)
+        __atomic_store_n(&q->nPushed, q->nPushed + 1, __ATOMIC_RELEASE);
+    else
+        q->nPushed++;
+    return el;
+} /* _stkqPush */
+
+
+stkEl_t *
+stkqFront(stkq_t *q)
+{
+    stkBlk_t *blk;
+
+    if((q->spsc ? __atomic_load_n(&q->nPushed, __ATOMIC_ACQUIRE) :
+                  q->nPushed) == q->nPopped)
+        return NULL;
+
+    /* head block used up, the next one holds the head */
+    if(q->head == BLK_FIRST(q->hblk) + q->blkSz)
+    {
+        blk = q->hblk;
+        q->hblk = listNext(blk);
+        q->head = BLK_FIRST(q->hblk);
+        blkPut(&q->spare, blk, q->spsc);
+    }
+    return q->head;
+} /* stkqFront */
+
+
+stkEl_t *
+stkqPop(stkq_t *q)
+{
+    stkEl_t *el;
+
+    if((el = stkqFront(q)) == NULL)
+        return NULL;
+    if(el->type == 's')
+        free(el->var.s);
+    q->head++;
+
+    /* only the consumer writing the count */
+    if(q->spsc)
+        __atomic_store_n(&q->nPopped, q->nPopped + 1, __ATOMIC_RELEASE);
+    else
+        q->nPopped++;
+    return stkqFront(q);
+} /* stkqPop */
+
+
+size_t
+stkqSize(const stkq_t *q)
+{
+    /* popped read first, so never more than pushed read after it */
+    size_t nPopped = __atomic_load_n(&q->nPopped, __ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&q->nPushed, __ATOMIC_ACQUIRE) - nPopped;
+} /* stkqSize */
+
+
+void
+stkqClear(stkq_t *q)
+{
+    while(stkqPop(q))
+        ;
+} /* stkqClear */
+
+
+void
+stkqDestroy(stkq_t *q)
+{
+    stkqClear(q);
+    blkFreeAll(q->hblk);
+    if(q->spsc)
+        free(q->spare);
+    else
+        blkFreeAll(q->spare);
+    free(q);
+} /* stkqDestroy */
+
+
+stkdq_t *
+stkdqNew(size_t blkSz)
+{
+    stkdq_t *dq;
+
+    if(blkSz == 0 || (dq = calloc(1, sizeof(*dq))) == NULL)
+        return NULL;
+    dq->blkSz = blkSz;
+    return dq;
+} /* stkdqNew */
+
+
+stkEl_t *
+_stkdqPush(stkdq_t *dq, int back, char type, stkVar_t var)
+{
+    stkEl_t *el;
+    stkBlk_t *blk = NULL;
+
+    if(varDup(type, &var))
+        return NULL;
+
+    /* a new block is needed if empty, or if the end is at block edge */
+    if(dq->size == 0 ||
+       (back ? dq->back == BLK_FIRST(dq->bblk) + dq->blkSz - 1 :
+               dq->front == BLK_FIRST(dq->fblk)))
+    {
+        if((blk = blkGet(&dq->spare, dq->blkSz, 0)) == NULL)
+        {
+            if(type == 's')
+                free(var.s);
+            return NULL;
+        }
+        blk->LIST_LINK = blk->LIST_LINK_(down) = NULL;
+    }
+
+    if(dq->size == 0)
+    {
+        /* from the middle, to grow either way */
+        dq->fblk = dq->bblk = blk;
+        el = dq->front = dq->back = BLK_FIRST(blk) + (dq->blkSz - 1) / 2;
+    }
+    else if(back)
+    {
+        if(blk)
+        {
+            blk->LIST_LINK_(down) = dq->bblk;
+            dq->bblk->LIST_LINK = blk;
+            dq->bblk = blk;
+            el = dq->back = BLK_FIRST(blk);
+        }
+        else
+            el = ++dq->back;
+    }
+    else
+    {
+        if(blk)
+        {
+            blk->LIST_LINK = dq->fblk;
+            dq->fblk->LIST_LINK_(down) = blk;
+            dq->fblk = blk;
+            el = dq->front = BLK_FIRST(blk) + dq->blkSz - 1;
+        }
+        else
+            el = --dq->front;
+    }
+
+    el->type = type;
+    el->var = var;
+    dq->size++;
+    return el;
+} /* _stkdqPush */
+
+
+/** empties double-ended queue after its last element is popped */
+static void
+stkdqEmpty(stkdq_t *dq)
+{
+    listAdd(dq->fblk, dq->spare);
+    dq->fblk = dq->bblk = NULL;
+    dq->front = dq->back = NULL;
+} /* stkdqEmpty */
+
+
+stkEl_t *
+stkdqPopFront(stkdq_t *dq)
+{
+    stkBlk_t *blk;
+
+    if(dq->size == 0)
+        return NULL;
+    if(dq->front->type == 's')
+        free(dq->front->var.s);
+    if(--dq->size == 0)
+    {
+        stkdqEmpty(dq);
+        return NULL;
+    }
+
+    /* step over to the next block if front was the last of its one */
+    if(dq->front == BLK_FIRST(dq->fblk) + dq->blkSz - 1)
+    {
+        blk = dq->fblk;
+        dq->fblk = listNext(blk);
+        dq->fblk->LIST_LINK_(down) = NULL;
+        dq->front = BLK_FIRST(dq->fblk);
+        listAdd(blk, dq->spare);
+    }
+    else
+        dq->front++;
+    return dq->front;
+} /* stkdqPopFront */
+
+
+stkEl_t *
+stkdqPopBack(stkdq_t *dq)
+{
+    stkBlk_t *blk;
+
+    if(dq->size == 0)
+        return NULL;
+    if(dq->back->type == 's')
+        free(dq->back->var.s);
+    if(--dq->size == 0)
+    {
+        stkdqEmpty(dq);
+        return NULL;
+    }
+
+    /* step back to the previous block if back was the first of its one */
+    if(dq->back == BLK_FIRST(dq->bblk))
+    {
+        blk = dq->bblk;
+        dq->bblk = listNext(blk, down);
+        dq->bblk->LIST_LINK = NULL;
+        dq->back = BLK_FIRST(dq->bblk) + dq->blkSz - 1;
+        listAdd(blk, dq->spare);
+    }
+    else
+        dq->back--;
+    return dq->back;
+} /* stkdqPopBack */
+
+
+void
+stkdqClear(stkdq_t *dq)
+{
+    while(stkdqPopFront(dq))
+        ;
+} /* stkdqClear */
+
+
+void
+stkdqDestroy(stkdq_t *dq)
+{
+    stkdqClear(dq);
+    blkFreeAll(dq->spare);
+    free(dq);
+} /* stkdqDestroy */
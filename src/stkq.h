@@ -0,0 +1,323 @@
+/**
+ * @file     stkq.h
+ * @brief    queue (first in - first out list) and double-ended queue
+ *           companions of the expanding stack
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Values and types are those of the expanding stack (stk.h), kept in
+ * blocks of wrapper elements chained like the stack's ones; blocks
+ * emptied at one end are recycled for growing at the other, so a queue in
+ * steady state allocates nothing. Strings are copied on push and freed on
+ * pop. Each operation is O(1).
+ *
+ * Queue (`stkq_t`):
+ *
+ *        head                                       tail
+ *        |                                          |
+ *        v                                          v
+ *        +--------------+        +--------------+
+ *        | (popped)     |        | value | type |
+ *        | value | type | -----> | ...          |
+ *        | ...          |  next  | (free)       |
+ *        +--------------+        +--------------+
+ *
+ * A queue created in single-producer single-consumer mode (`STKQ_SPSC`)
+ * can be pushed into by one thread while another one pops from it,
+ * without locking: each end publishes its own count of elements pushed or
+ * popped to the other one, and a spare block is passed over atomically.
+ *
+ * Double-ended queue (`stkdq_t`) grows in both directions from the middle
+ * of its first block; it is not for concurrent use.
+ *
+ * Usage example:
+ *
+ *        stkq_t *q = stkqNew(128, 0);
+ *        stkqPushInt(q, 10);
+ *        if(stkqFront(q))
+ *            printf("front: %d\n", stkqFront(q)->var.i);
+ *        stkqPop(q);
+ *        stkqDestroy(q);
+ */
+
+
+#ifndef __STKQ_H
+#define __STKQ_H
+
+
+#include <stddef.h>
+
+#include "stk.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** single-producer single-consumer mode of queue, see `stkqNew()` */
+#define STKQ_SPSC 1
+
+/** size of cache line the ends of queue are aligned to, so the producer
+ *  and the consumer do not write the same one */
+#define STKQ_LINE 64
+
+/** pushes variable to the tail of queue by type given at run time */
+#define stkqPush(q, type, var) \
+        _stkqPush(q, type, (stkVar_t)(var))
+#define stkqPushInt(q, Int) \
+        _stkqPush(q, 'i', (stkVar_t)(int)(Int))     /**< pushes integer */
+#define stkqPushDbl(q, Dbl) \
+        _stkqPush(q, 'd', (stkVar_t)(double)(Dbl))  /**< pushes double */
+#define stkqPushChr(q, Chr) \
+        _stkqPush(q, 'c', (stkVar_t)(char)(Chr))    /**< pushes character */
+#define stkqPushStr(q, Str) \
+        _stkqPush(q, 's', (stkVar_t)(char *)(Str))  /**< pushes string */
+#define stkqPushPtr(q, Ptr) \
+        _stkqPush(q, 'p', (stkVar_t)(void *)(Ptr))  /**< pushes pointer */
+
+/** pushes variable to the front of double-ended queue by type given at run
+ *  time, see `_stkdqPush()` */
+#define stkdqPushFront(dq, type, var) \
+        _stkdqPush(dq, 0, type, (stkVar_t)(var))
+/** pushes variable to the back of double-ended queue by type given at run
+ *  time, see `_stkdqPush()` */
+#define stkdqPushBack(dq, type, var) \
+        _stkdqPush(dq, 1, type, (stkVar_t)(var))
+#define stkdqPushFrontInt(dq, Int) \
+        _stkdqPush(dq, 0, 'i', (stkVar_t)(int)(Int))    /**< pushes integer */
+#define stkdqPushFrontDbl(dq, Dbl) \
+        _stkdqPush(dq, 0, 'd', (stkVar_t)(double)(Dbl)) /**< pushes double */
+#define stkdqPushFrontChr(dq, Chr) \
+        _stkdqPush(dq, 0, 'c', (stkVar_t)(char)(Chr))   /**< pushes char */
+#define stkdqPushFrontStr(dq, Str) \
+        _stkdqPush(dq, 0, 's', (stkVar_t)(char *)(Str)) /**< pushes string */
+#define stkdqPushFrontPtr(dq, Ptr) \
+        _stkdqPush(dq, 0, 'p', (stkVar_t)(void *)(Ptr)) /**< pushes pointer */
+#define stkdqPushBackInt(dq, Int) \
+        _stkdqPush(dq, 1, 'i', (stkVar_t)(int)(Int))    /**< pushes integer */
+#define stkdqPushBackDbl(dq, Dbl) \
+        _stkdqPush(dq, 1, 'd', (stkVar_t)(double)(Dbl)) /**< pushes double */
+#define stkdqPushBackChr(dq, Chr) \
+        _stkdqPush(dq, 1, 'c', (stkVar_t)(char)(Chr))   /**< pushes char */
+#define stkdqPushBackStr(dq, Str) \
+        _stkdqPush(dq, 1, 's', (stkVar_t)(char *)(Str)) /**< pushes string */
+#define stkdqPushBackPtr(dq, Ptr) \
+        _stkdqPush(dq, 1, 'p', (stkVar_t)(void *)(Ptr)) /**< pushes pointer */
+
+/** gets number of elements in double-ended queue */
+#define stkdqSize(dq) \
+        ((dq)->size)
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct
+{
+    /* members for administrative use only */
+
+    size_t blkSz;               /* number of elements per block */
+    int spsc;                   /* whether in single-producer
+                                   single-consumer mode */
+    stkBlk_t *spare;            /* recycled blocks; in single-producer
+                                   single-consumer mode at most one,
+                                   exchanged atomically */
+
+    /* consumer end, on a cache line of its own */
+    __attribute__((aligned(STKQ_LINE)))
+    stkEl_t *head;              /* next element to pop, may be the end of
+                                   head block */
+    stkBlk_t *hblk;             /* block of head */
+    size_t nPopped;             /* number of elements popped, published
+                                   to the producer (atomic in single-
+                                   producer single-consumer mode) */
+
+    /* producer end, on a cache line of its own */
+    __attribute__((aligned(STKQ_LINE)))
+    stkEl_t *tail;              /* next element to push into, may be the
+                                   end of tail block */
+    stkBlk_t *tblk;             /* block of tail */
+    size_t nPushed;             /* number of elements pushed, published
+                                   to the consumer (atomic likewise) */
+
+} stkq_t; /* queue */
+
+
+typedef struct
+{
+    stkEl_t *front;             /* front element, NULL if empty */
+    stkEl_t *back;              /* back element, NULL if empty */
+    size_t size;                /* number of elements */
+
+    /* members for administrative use only */
+
+    size_t blkSz;               /* number of elements per block */
+    stkBlk_t *fblk;             /* block of front element */
+    stkBlk_t *bblk;             /* block of back element */
+    stkBlk_t *spare;            /* list of recycled blocks */
+
+} stkdq_t; /* double-ended queue */
+
+
+/* ----- function signatures ----------------------------------------------- */
+
+
+/**
+ * creates a new queue
+ *
+ * @param  blkSz  number of elements allocated together, at least 1
+ * @param  flags  0, or `STKQ_SPSC` for single-producer single-consumer
+ *                mode
+ * @return        new queue on success; NULL otherwise
+ */
+stkq_t *
+stkqNew(size_t blkSz, int flags)
+    __attribute__((malloc, warn_unused_result));
+
+
+/**
+ * pushes a variable to the tail of queue
+ *
+ * @param  q     queue, previously created with `stkqNew()`
+ * @param  type  type of variable to push, see `_stkPush()`
+ * @param  var   union of compatible variables to push
+ * @return       address of the pushed variable's wrapper element on
+ *               success; NULL otherwise
+ * @warning      in single-producer single-consumer mode the element may be
+ *               popped by the consumer as soon as it is pushed
+ * @note         intended to be used through `stkqPushXxx()` macros; in
+ *               single-producer single-consumer mode to be called by the
+ *               producer only
+ */
+stkEl_t *
+_stkqPush(stkq_t *q, char type, stkVar_t var)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * gets the element at the head of queue, the one to be popped next
+ *
+ * @return  address of head element; NULL if queue is empty
+ * @note    in single-producer single-consumer mode to be called by the
+ *          consumer only
+ */
+stkEl_t *
+stkqFront(stkq_t *q)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * removes the head element from queue and frees possibly allocated
+ * resources belonging to it
+ *
+ * @return  address of new head element after pop; NULL if empty
+ * @note    in single-producer single-consumer mode to be called by the
+ *          consumer only
+ */
+stkEl_t *
+stkqPop(stkq_t *q)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * gets number of elements in queue
+ *
+ * @note  in single-producer single-consumer mode it may change right away
+ */
+size_t
+stkqSize(const stkq_t *q)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * clears queue by popping each element out from it
+ */
+void
+stkqClear(stkq_t *q)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * destroys queue by freeing all allocated resources regarding
+ */
+void
+stkqDestroy(stkq_t *q)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * creates a new double-ended queue
+ *
+ * @param  blkSz  number of elements allocated together, at least 1
+ * @return        new double-ended queue on success; NULL otherwise
+ */
+stkdq_t *
+stkdqNew(size_t blkSz)
+    __attribute__((malloc, warn_unused_result));
+
+
+/**
+ * pushes a variable to either end of double-ended queue
+ *
+ * @param  dq    double-ended queue, previously created with `stkdqNew()`
+ * @param  back  whether to push to the back (or to the front)
+ * @param  type  type of variable to push, see `_stkPush()`
+ * @param  var   union of compatible variables to push
+ * @return       address of the pushed variable's wrapper element on
+ *               success; NULL otherwise
+ * @note         intended to be used through `stkdqPushFront()` and
+ *               `stkdqPushBack()`
+ */
+stkEl_t *
+_stkdqPush(stkdq_t *dq, int back, char type, stkVar_t var)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * removes the front element from double-ended queue and frees possibly
+ * allocated resources belonging to it
+ *
+ * @return  address of new front element after pop; NULL if empty
+ */
+stkEl_t *
+stkdqPopFront(stkdq_t *dq)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * removes the back element from double-ended queue, see `stkdqPopFront()`
+ *
+ * @return  address of new back element after pop; NULL if empty
+ */
+stkEl_t *
+stkdqPopBack(stkdq_t *dq)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * clears double-ended queue by popping each element out from it
+ */
+void
+stkdqClear(stkdq_t *dq)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * destroys double-ended queue by freeing all allocated resources regarding
+ */
+void
+stkdqDestroy(stkdq_t *dq)
+    __attribute__((nonnull(1)));
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __STKQ_H */
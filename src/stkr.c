@@ -0,0 +1,114 @@
+/**
+ * @file     stkr.c
+ * @brief    bounded stack overwriting its oldest element when full
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "stkr.h"
+
+
+/* ----- function definitions ---------------------------------------------- */
+
+
+stkr_t *
+stkrNew(size_t cap)
+{
+    stkr_t *r;
+
+    if(cap == 0 || (r = calloc(1, sizeof(*r))) == NULL)
+        return NULL;
+    if((r->els = malloc(sizeof(*r->els) * cap)) == NULL)
+    {
+        free(r);
+        return NULL;
+    }
+    r->cap = cap;
+    r->cur = r->els;
+    return r;
+} /* stkrNew */
+
+
+stkEl_t *
+_stkrPush(stkr_t *r, char type, stkVar_t var)
+{
+    stkEl_t *el = r->cur;
+
+    switch(type)
+    {
+        case 'i': case 'd': case 'c': case 'p':
+            break;
+        case 's':
+            if((var.s = strdup(var.s)) == NULL)
+                return NULL;
+            break;
+        default:
+            return NULL;
+    }
+
+    /* when full, the next element is the bottom one */
+    if(r->size == r->cap)
+    {
+        if(el->type == 's')
+            free(el->var.s);
+        r->dropped++;
+    }
+    else
+        r->size++;
+
+    el->type = type;
+    el->var = var;
+    r->cur = el + 1 < r->els + r->cap ? el + 1 : r->els;
+    return r->top = el;
+} /* _stkrPush */
+
+
+stkEl_t *
+stkrPop(stkr_t *r)
+{
+    stkEl_t *el;
+
+    if((el = r->top))
+    {
+        if(el->type == 's')
+            free(el->var.s);
+        r->cur = el;
+        r->top = --r->size == 0 ? NULL :
+                 el > r->els ? el - 1 : r->els + r->cap - 1;
+    }
+    return r->top;
+} /* stkrPop */
+
+
+stkEl_t *
+stkrPeek(stkr_t *r, size_t n)
+{
+    size_t i;
+
+    if(n >= r->size)
+        return NULL;
+    i = r->top - r->els;
+    return r->els + (i >= n ? i - n : i + r->cap - n);
+} /* stkrPeek */
+
+
+void
+stkrClear(stkr_t *r)
+{
+    while(stkrPop(r))
+        ;
+} /* stkrClear */
+
+
+void
+stkrDestroy(stkr_t *r)
+{
+    stkrClear(r);
+    free(r->els);
+    free(r);
+} /* stkrDestroy */
@@ -0,0 +1,159 @@
+/**
+ * @file     stkr.h
+ * @brief    bounded stack overwriting its oldest element when full
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Stack of fixed maximum depth for undo histories and traces of recent
+ * events: elements are kept in a ring of wrapper elements allocated on
+ * creation, and pushing onto a full stack drops the bottom element, so
+ * both push and pop are O(1) and memory is capped regardless of input.
+ * Values and types are those of the expanding stack (stk.h), strings are
+ * copied on push and freed on pop and drop likewise; top element access
+ * macros of stk.h (`stkIsEmpty()`, `stkSize()`, `stkType()`, `stkIsXxx()`,
+ * `stkVal()`, `stkValXxx()`) work on bounded stacks as well.
+ *
+ *        +------------------------------------------------+
+ *        | value | value | value | (free) | value | value  |
+ *        +------------------------------------------------+
+ *                            ^ top          ^ bottom
+ *
+ * Usage example:
+ *
+ *        stkr_t *r = stkrNew(100);
+ *        stkrPushStr(r, "edit");
+ *        if(!stkIsEmpty(r))
+ *            printf("undo: %s\n", stkValStr(r));
+ *        stkrDestroy(r);
+ */
+
+
+#ifndef __STKR_H
+#define __STKR_H
+
+
+#include <stddef.h>
+
+#include "stk.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** pushes variable into bounded stack by type given at run time */
+#define stkrPush(r, type, var) \
+        _stkrPush(r, type, (stkVar_t)(var))
+#define stkrPushInt(r, Int) \
+        _stkrPush(r, 'i', (stkVar_t)(int)(Int))     /**< pushes integer */
+#define stkrPushDbl(r, Dbl) \
+        _stkrPush(r, 'd', (stkVar_t)(double)(Dbl))  /**< pushes double */
+#define stkrPushChr(r, Chr) \
+        _stkrPush(r, 'c', (stkVar_t)(char)(Chr))    /**< pushes character */
+#define stkrPushStr(r, Str) \
+        _stkrPush(r, 's', (stkVar_t)(char *)(Str))  /**< pushes string */
+#define stkrPushPtr(r, Ptr) \
+        _stkrPush(r, 'p', (stkVar_t)(void *)(Ptr))  /**< pushes pointer */
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct
+{
+    stkEl_t *top;               /* stack top element, NULL if empty */
+    size_t size;                /* number of elements in stack */
+    size_t dropped;             /* number of elements dropped from bottom */
+
+    /* members for administrative use only */
+
+    size_t cap;                 /* maximum number of elements */
+    stkEl_t *cur;               /* next element to push into */
+    stkEl_t *els;               /* ring of elements */
+
+} stkr_t; /* bounded stack */
+
+
+/* ----- function signatures ----------------------------------------------- */
+
+
+/**
+ * creates a new bounded stack
+ *
+ * @param  cap  maximum number of elements, allocated at once
+ * @return      new bounded stack on success; NULL if cap is 0 or memory
+ *              could not be allocated
+ */
+stkr_t *
+stkrNew(size_t cap)
+    __attribute__((malloc, warn_unused_result));
+
+
+/**
+ * pushes a variable into bounded stack, dropping the bottom element if
+ * stack is full
+ *
+ * @param  r     bounded stack, previously created with `stkrNew()`
+ * @param  type  type of variable to push, see `_stkPush()`
+ * @param  var   union of compatible variables to push
+ * @return       address of the pushed variable's wrapper element on
+ *               success; NULL otherwise (wrong type or string could not be
+ *               copied), in which case stack is left intact
+ * @note         intended to be used through `stkrPushXxx()` macros
+ */
+stkEl_t *
+_stkrPush(stkr_t *r, char type, stkVar_t var)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * removes the top element from bounded stack and frees possibly allocated
+ * resources belonging to it
+ *
+ * @return  address of new top element after pop; NULL if empty
+ */
+stkEl_t *
+stkrPop(stkr_t *r)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * gets the element at given depth in bounded stack without removing
+ * anything
+ *
+ * @param  n  depth of element, counted from the top (0 for the top one)
+ * @return    address of element; NULL if stack holds no more than n
+ *            elements
+ */
+stkEl_t *
+stkrPeek(stkr_t *r, size_t n)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * clears bounded stack by popping each element out from it
+ */
+void
+stkrClear(stkr_t *r)
+    __attribute__((nonnull(1)));
+
+
+/**
+ * destroys bounded stack by freeing all allocated resources regarding
+ */
+void
+stkrDestroy(stkr_t *r)
+    __attribute__((nonnull(1)));
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __STKR_H */
@@ -0,0 +1,392 @@
+/**
+ * @file     ulist.h
+ * @brief    unrolled list storing several entries per node
+ * @author   Tamas Dezso <dezso.t.tamas@gmail.com>
+ * @date     October 18, 2026
+ * @version  1.0
+ *
+ * Entries (of small payload, by value) are kept in arrays of up to k in
+ * doubly linked nodes, so a scan reads whole cache lines of entries with
+ * a single link per node instead of per entry. Entries are added at
+ * either end in O(1), filling the end node before adding a new one.
+ * Deletion closes the gap within the node, and merges it with its
+ * neighbour if they fit in one, so nodes stay more than half full on
+ * average. Pointers to entries are invalidated by deletions.
+ *
+ *        ul
+ *        +------+      +-------------+      +-------------+
+ *        | head |----> | lo hi prev  | <--> | lo hi next  |
+ *        | tail |--.   | [ - a b c ] |      | [ d e f - ] |
+ *        +------+  |   +-------------+      +-------------+
+ *                  '-----------------------------^
+ *
+ * @param  ul     unrolled list variable, declared by `ULIST()`
+ * @param  cmpfn  compare function, returning zero for a match
+ * @param  fld    member field of entries to be compared, together with the
+ *                member access operator (->), or [0] to compare whole
+ *                entries, or empty to pass pointers of entries
+ *
+ * Usage example:
+ *
+ *        ULIST(int, 14) ul = ULIST_INIT;
+ *        ULIST_NODE(ul) node;
+ *        int *pos;
+ *
+ *        ulistAddTail(ul, 10);
+ *        ulistForEach(pos, node, ul)
+ *            printf("%d\n", *pos);
+ *        ulistDelMatch(ul, NUMCMP, [0], 10);
+ *        ulistDestroy(ul);
+ */
+
+
+#ifndef __ULIST_H
+#define __ULIST_H
+
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/**
+ * declares an unrolled list of entries of given type
+ *
+ * @param  type  type of entries
+ * @param  k     number of entries per node, at least 1; best chosen so
+ *               that a node fills whole cache lines
+ */
+#define ULIST(type, k)                                                        \
+        struct {                                                              \
+            struct {                                                          \
+                unsigned lo, hi; /* entries used, from lo to before hi */     \
+                void *prev, *next; /* neighbour nodes */                      \
+                type els[k];    /* entries */                                 \
+            } *head, *tail;     /* first and last nodes */                    \
+            unsigned long n;    /* number of entries */                       \
+        }
+
+
+/** initializer of an empty unrolled list */
+#define ULIST_INIT       { NULL, NULL, 0 }
+
+
+/** type of node pointers of an unrolled list, for node cursors */
+#define ULIST_NODE(ul) \
+        typeof((ul).head)
+
+
+/** gets number of entries per node */
+#define _ulistK(ul) \
+        (sizeof((ul).head->els) / sizeof((ul).head->els[0]))
+
+
+/** gets number of entries in unrolled list */
+#define ulistSize(ul) \
+        ((ul).n)
+
+
+/** gets pointer of first entry, NULL if empty */
+#define ulistFront(ul) \
+        ((ul).head ? &(ul).head->els[(ul).head->lo] : NULL)
+
+
+/** gets pointer of last entry, NULL if empty */
+#define ulistBack(ul) \
+        ((ul).tail ? &(ul).tail->els[(ul).tail->hi - 1] : NULL)
+
+
+/**
+ * iterates over entries of unrolled list, in a single loop
+ *
+ * @param  pos   loop cursor variable (type *)
+ * @param  node  node cursor variable (`ULIST_NODE(ul)`)
+ * @param  ul    unrolled list variable; must not be modified meanwhile
+ */
+#define ulistForEach(pos, node, ul)                                           \
+        for(node = (ul).head, pos = node ? &node->els[node->lo] : NULL;       \
+            pos != NULL;                                                      \
+            (void)(++pos < &node->els[node->hi] ||                            \
+                   (pos = (node = node->next) ? &node->els[node->lo] : NULL)))
+
+
+/**
+ * finds first matching entry
+ *
+ * @param  ul     unrolled list variable
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see above
+ * @param  args   arguments to pass over to the compare function containing
+ *                the other entity to compare with at the first place and
+ *                other optional parameters of comparison afterwards
+ * @return        pointer of first true entry, if any; NULL otherwise
+ */
+#define ulistFind(ul, cmpfn, fld, args...)                                    \
+({                                                                            \
+        ULIST_NODE(ul) __nd;                                                  \
+        typeof(&(ul).head->els[0]) __i;                                       \
+                                                                              \
+        ulistForEach(__i, __nd, ul)                                           \
+            if(cmpfn(__i fld, args) == 0)                                     \
+                break;                                                        \
+        __i;                                                                  \
+})
+
+
+/**
+ * allocates an empty node, its entries to start at a given index
+ *
+ * @note  used by the macros below, not to be called directly
+ */
+#define _ulistNew(ul, at)                                                     \
+({                                                                            \
+        ULIST_NODE(ul) __new = malloc(sizeof(*(ul).head));                    \
+                                                                              \
+        if(__new) {                                                           \
+            __new->lo = __new->hi = (at);                                     \
+            __new->prev = __new->next = NULL;                                 \
+        }                                                                     \
+        __new;                                                                \
+})
+
+
+/**
+ * unlinks node and frees it
+ *
+ * @note  used by the macros below, not to be called directly
+ */
+#define _ulistUnlink(ul, node)                                                \
+({                                                                            \
+        ULIST_NODE(ul) __un = (node), __prev = __un->prev,                    \
+                       __next = __un->next;                                   \
+                                                                              \
+        if(__prev)                                                            \
+            __prev->next = __next;                                            \
+        else                                                                  \
+            (ul).head = __next;                                               \
+        if(__next)                                                            \
+            __next->prev = __prev;                                            \
+        else                                                                  \
+            (ul).tail = __prev;                                               \
+        free(__un);                                                           \
+})
+
+
+/**
+ * frees node if it is emptied, or merges it into the previous one if
+ * their entries fit in one
+ *
+ * @return  true if node is freed; false otherwise
+ * @note    used by the macros below, not to be called directly
+ */
+#define _ulistCompact(ul, node)                                               \
+({                                                                            \
+        ULIST_NODE(ul) __cn = (node), __pv = __cn->prev;                      \
+        unsigned __cnt = __cn->hi - __cn->lo;                                 \
+        int __freed = 1;                                                      \
+                                                                              \
+        if(__cnt == 0)                                                        \
+            _ulistUnlink(ul, __cn);                                           \
+        else if(__pv && __pv->hi - __pv->lo + __cnt <= _ulistK(ul)) {         \
+            if(__pv->hi + __cnt > _ulistK(ul)) {                              \
+                memmove(__pv->els, &__pv->els[__pv->lo],                      \
+                        (__pv->hi - __pv->lo) * sizeof(__pv->els[0]));        \
+                __pv->hi -= __pv->lo;                                         \
+                __pv->lo = 0;                                                 \
+            }                                                                 \
+            memcpy(&__pv->els[__pv->hi], &__cn->els[__cn->lo],                \
+                   __cnt * sizeof(__cn->els[0]));                             \
+            __pv->hi += __cnt;                                                \
+            _ulistUnlink(ul, __cn);                                           \
+        } else                                                                \
+            __freed = 0;                                                      \
+        __freed;                                                              \
+})
+
+
+/**
+ * inserts new entry at front
+ *
+ * @param  ul   unrolled list variable
+ * @param  val  value of the new entry
+ * @return      pointer of the new entry; NULL if a node could not be
+ *              allocated
+ */
+#define ulistAdd(ul, val)                                                     \
+({                                                                            \
+        ULIST_NODE(ul) __nd = (ul).head;                                      \
+        typeof(&(ul).head->els[0]) __el = NULL;                               \
+                                                                              \
+        /* the first node from the middle, to grow either way; from the   \
+           end if it is a single entry one */                                 \
+        if(__nd == NULL || __nd->lo == 0) {                                   \
+            if((__nd = _ulistNew(ul, __nd ? _ulistK(ul) :                     \
+                                             (_ulistK(ul) + 1) / 2))) {       \
+                if((__nd->next = (ul).head))                                  \
+                    (ul).head->prev = __nd;                                   \
+                else                                                          \
+                    (ul).tail = __nd;                                         \
+                (ul).head = __nd;                                             \
+            }                                                                 \
+        }                                                                     \
+        if(__nd) {                                                            \
+            __el = &__nd->els[--__nd->lo];                                    \
+            *__el = (val);                                                    \
+            (ul).n++;                                                         \
+        }                                                                     \
+        __el;                                                                 \
+})
+
+
+/**
+ * inserts new entry at back
+ *
+ * @param  ul   unrolled list variable
+ * @param  val  value of the new entry
+ * @return      pointer of the new entry; NULL if a node could not be
+ *              allocated
+ */
+#define ulistAddTail(ul, val)                                                 \
+({                                                                            \
+        ULIST_NODE(ul) __nd = (ul).tail;                                      \
+        typeof(&(ul).head->els[0]) __el = NULL;                               \
+                                                                              \
+        if(__nd == NULL || __nd->hi == _ulistK(ul)) {                         \
+            if((__nd = _ulistNew(ul, __nd ? 0 : _ulistK(ul) / 2))) {          \
+                if((__nd->prev = (ul).tail))                                  \
+                    (ul).tail->next = __nd;                                   \
+                else                                                          \
+                    (ul).head = __nd;                                         \
+                (ul).tail = __nd;                                             \
+            }                                                                 \
+        }                                                                     \
+        if(__nd) {                                                            \
+            __el = &__nd->els[__nd->hi++];                                    \
+            *__el = (val);                                                    \
+            (ul).n++;                                                         \
+        }                                                                     \
+        __el;                                                                 \
+})
+
+
+/**
+ * removes first entry (if list is not empty)
+ *
+ * @param  ul  unrolled list variable
+ * @return     pointer of the new first entry, NULL if none
+ */
+#define ulistDelFront(ul)                                                     \
+({                                                                            \
+        ULIST_NODE(ul) __f = (ul).head;                                       \
+                                                                              \
+        if(__f) {                                                             \
+            (ul).n--;                                                         \
+            if(++__f->lo == __f->hi) {                                        \
+                if(((ul).head = __f->next))                                   \
+                    (ul).head->prev = NULL;                                   \
+                else                                                          \
+                    (ul).tail = NULL;                                         \
+                free(__f);                                                    \
+            }                                                                 \
+        }                                                                     \
+        ulistFront(ul);                                                       \
+})
+
+
+/**
+ * removes last entry (if list is not empty)
+ *
+ * @param  ul  unrolled list variable
+ * @return     pointer of the new last entry, NULL if none
+ */
+#define ulistDelBack(ul)                                                      \
+({                                                                            \
+        ULIST_NODE(ul) __b = (ul).tail;                                       \
+                                                                              \
+        if(__b) {                                                             \
+            (ul).n--;                                                         \
+            if(--__b->hi == __b->lo) {                                        \
+                if(((ul).tail = __b->prev))                                   \
+                    (ul).tail->next = NULL;                                   \
+                else                                                          \
+                    (ul).head = NULL;                                         \
+                free(__b);                                                    \
+            }                                                                 \
+        }                                                                     \
+        ulistBack(ul);                                                        \
+})
+
+
+/**
+ * removes entry, closing the gap in its node and merging it with a
+ * neighbour if they fit in one
+ *
+ * @param  ul    unrolled list variable
+ * @param  node  node of entry, e.g., the node cursor of `ulistForEach()`
+ * @param  pos   pointer of entry; cursors are invalid afterwards
+ */
+#define ulistDel(ul, node, pos)                                               \
+({                                                                            \
+        ULIST_NODE(ul) __dn = (node), __dnx = __dn->next;                     \
+        typeof(&(ul).head->els[0]) __p = (pos);                               \
+                                                                              \
+        memmove(__p, __p + 1, (&__dn->els[__dn->hi] - (__p + 1)) *            \
+                              sizeof(*__p));                                  \
+        __dn->hi--;                                                           \
+        (ul).n--;                                                             \
+        /* into the previous one, or the next one into it */                  \
+        if(!_ulistCompact(ul, __dn) && __dnx)                                 \
+            _ulistCompact(ul, __dnx);                                         \
+})
+
+
+/**
+ * removes each matching entry in a single pass, compacting nodes
+ *
+ * @param  ul     unrolled list variable
+ * @param  cmpfn  compare function
+ * @param  fld    member field to be compared, see above
+ * @param  args   arguments to pass over to the compare function, see
+ *                `ulistFind()`
+ * @return        void
+ */
+#define ulistDelMatch(ul, cmpfn, fld, args...)                                \
+({                                                                            \
+        ULIST_NODE(ul) __nd, __nx;                                            \
+        unsigned __r, __w;                                                    \
+                                                                              \
+        for(__nd = (ul).head; __nd; __nd = __nx) {                            \
+            __nx = __nd->next;                                                \
+            for(__r = __w = __nd->lo; __r < __nd->hi; __r++)                  \
+                if(cmpfn((&__nd->els[__r]) fld, args) == 0)                   \
+                    (ul).n--;                                                 \
+                else if(__w++ != __r)                                         \
+                    __nd->els[__w - 1] = __nd->els[__r];                      \
+            __nd->hi = __w;                                                   \
+            /* into the previous one, already done */                         \
+            _ulistCompact(ul, __nd);                                          \
+        }                                                                     \
+})
+
+
+/**
+ * frees every node of unrolled list, leaving it empty
+ *
+ * @param  ul  unrolled list variable
+ */
+#define ulistDestroy(ul)                                                      \
+({                                                                            \
+        ULIST_NODE(ul) __nd, __nx;                                            \
+                                                                              \
+        for(__nd = (ul).head; __nd; __nd = __nx) {                            \
+            __nx = __nd->next;                                                \
+            free(__nd);                                                       \
+        }                                                                     \
+        (ul).head = (ul).tail = NULL;                                         \
+        (ul).n = 0;                                                           \
+})
+
+
+#endif /* __ULIST_H */
@@ -0,0 +1,166 @@
+/**
+ * @file     cache_test.c
+ * @brief    bounded intrusive cache unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "cache.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+#define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
+#define NUMHASH(X)   ((unsigned long)(X) * 2654435761u)
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct entry_t entry_t;
+struct entry_t
+{
+    int key;
+    int evicted;
+    CACHE_LINKS(entry_t,);
+    CACHE_LINKS(entry_t, other);
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+static unsigned long nEvicted;
+
+/** marks entry as evicted */
+static void evict(entry_t *e)
+{
+    e->evicted++;
+    nEvicted++;
+}
+
+/** compares keys, counting calls */
+static int cmpCount(int a, int b, unsigned long *n)
+{
+    (*n)++;
+    return NUMCMP(a, b);
+}
+
+/** tests lookups, counters and CLOCK eviction */
+static void test_clock()
+{
+    CACHE(entry_t) c;
+    entry_t arr[150] = { 0 }, dup = { .key = 3 };
+    int i, n;
+
+    nEvicted = 0;
+    assert_int_equal(cacheInit(c, 100), 0);
+    for(i = 0; i < 150; i++)
+        arr[i].key = i;
+
+    for(i = 0; i < 100; i++)
+        assert_true(cacheAdd(&arr[i], c,, NUMHASH, NUMCMP, ->key, evict));
+    assert_false(cacheAdd(&dup, c,, NUMHASH, NUMCMP, ->key, evict));
+    assert_int_equal(cacheSize(c), 100);
+
+    /* odd ones referenced */
+    for(i = 1; i < 100; i += 2)
+        assert_ptr_equal(cacheFind(c,, NUMHASH, NUMCMP, ->key, i), &arr[i]);
+    assert_null(cacheFind(c,, NUMHASH, NUMCMP, ->key, 100));
+    assert_int_equal(c.hits, 50);
+    assert_int_equal(c.misses, 1);
+
+    /* unreferenced even ones go first */
+    for(i = 100; i < 150; i++)
+        assert_true(cacheAdd(&arr[i], c,, NUMHASH, NUMCMP, ->key, evict));
+    assert_int_equal(cacheSize(c), 100);
+    assert_int_equal(c.evictions, 50);
+    assert_int_equal(nEvicted, 50);
+    for(i = 0; i < 100; i++) {
+        assert_int_equal(arr[i].evicted, i % 2 == 0);
+        if(i % 2)
+            assert_non_null(cacheFind(c,, NUMHASH, NUMCMP, ->key, i));
+        else
+            assert_null(cacheFind(c,, NUMHASH, NUMCMP, ->key, i));
+    }
+
+    /* referenced ones had their second chance, the clock sweeps on */
+    assert_true(cacheAdd(&arr[0], c,, NUMHASH, NUMCMP, ->key, evict));
+    assert_int_equal(c.evictions, 51);
+
+    /* removal, then all the rest evicted on destroy */
+    assert_ptr_equal(cacheDel(c,, NUMHASH, NUMCMP, ->key, 0), &arr[0]);
+    assert_null(cacheDel(c,, NUMHASH, NUMCMP, ->key, 0));
+    n = cacheSize(c);
+    assert_int_equal(n, 99);
+    cacheDestroy(c,, evict);
+    assert_int_equal(nEvicted, 51 + n);
+    assert_null(c.hand);
+}
+
+/** tests entries in two caches, churning through a small one */
+static void test_twoCaches()
+{
+    CACHE(entry_t) small, big;
+    entry_t *arr = calloc(MANY, sizeof(*arr)), *hit;
+    unsigned long nCmp = 0;
+    int i;
+
+    nEvicted = 0;
+    assert_int_equal(cacheInit(small, 1), 0);
+    assert_int_equal(cacheInit(big, MANY), 0);
+    for(i = 0; i < MANY; i++) {
+        arr[i].key = i;
+        assert_true(cacheAdd(&arr[i], big, other, NUMHASH, NUMCMP, ->key,
+                             evict));
+        assert_true(cacheAdd(&arr[i], small,, NUMHASH, cmpCount, ->key,
+                             evict, &nCmp));
+        hit = cacheFind(small,, NUMHASH, cmpCount, ->key, i, &nCmp);
+        assert_ptr_equal(hit, &arr[i]);
+    }
+    /* compare arguments passed over to eviction as well */
+    assert_true(nCmp >= 2 * MANY - 1);
+    assert_int_equal(cacheSize(small), 1);
+    assert_int_equal(small.evictions, MANY - 1);
+    assert_int_equal(big.evictions, 0);
+
+    /* deletion of the single entry, and of ones all around the clock */
+    assert_ptr_equal(cacheDel(small,, NUMHASH, NUMCMP, ->key, MANY - 1),
+                     &arr[MANY - 1]);
+    assert_null(small.hand);
+    for(i = 0; i < MANY; i += 1000)
+        assert_ptr_equal(cacheDel(big, other, NUMHASH, NUMCMP, ->key, i),
+                         &arr[i]);
+    assert_int_equal(cacheSize(big), MANY - MANY/1000);
+    hit = cacheFind(big, other, NUMHASH, NUMCMP, ->key, 1);
+    assert_ptr_equal(hit, &arr[1]);
+
+    nEvicted = 0;
+    cacheDestroy(small,, evict);
+    cacheDestroy(big, other, evict);
+    assert_int_equal(nEvicted, MANY - MANY/1000);
+    free(arr);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_clock),      /* init, add, find, del, destroy */
+        cmocka_unit_test(test_twoCaches),  /* init, add, find, del, destroy */
+    };
+
+    return cmocka_run_group_tests_name("Cache tests", tests, NULL, NULL);
+}
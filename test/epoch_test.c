@@ -0,0 +1,191 @@
+/**
+ * @file     epoch_test.c
+ * @brief    epoch-based reclamation unit tests utilizing the cmocka
+ *           framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <cmocka.h>
+
+#include "epoch.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** number of reader threads, routes and replacements by the writer */
+#define READERS  4
+#define ROUTES   16
+#define UPDATES  20000
+
+#define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct route_t route_t;
+struct route_t
+{
+    int dest;
+    int dead;
+    route_t *LIST_LINK;
+    route_t *LIST_LINK_(grave);
+};
+
+
+/* ----- globals ----------------------------------------------------------- */
+
+
+/** list of routes read, and of those "freed" */
+static route_t *_routes, *_graves;
+
+/** number of objects freed, of dead routes seen, and readers' stop flag */
+static unsigned long _nFreed, _nDeadSeen;
+static int _stop;
+
+static epoch_t *_dom;
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** counts object freed */
+static void countFree(void *ptr)
+{
+    (void)ptr;
+    _nFreed++;
+}
+
+/** marks route dead, keeping it to be freed at the end */
+static void bury(void *ptr)
+{
+    route_t *r = ptr;
+
+    __atomic_store_n(&r->dead, 1, __ATOMIC_RELEASE);
+    listAddAtomic(r, _graves, grave);
+    __atomic_add_fetch(&_nFreed, 1, __ATOMIC_RELAXED);
+}
+
+/** tests objects are freed only after read sections left */
+static void test_retire()
+{
+    epoch_t *dom = epochNew();
+    epochThr_t *thr = epochRegister(dom);
+    int objs[3], i;
+
+    _nFreed = 0;
+    epochEnter(thr);
+    epochEnter(thr);                    /* nested */
+    for(i = 0; i < 3; i++)
+        epochRetire(dom, &objs[i], countFree);
+    for(i = 0; i < 5; i++)
+        assert_int_equal(epochReclaim(dom), 0);
+    epochLeave(thr);
+    assert_int_equal(epochReclaim(dom), 0);
+    epochLeave(thr);
+
+    /* held at one epoch after theirs, then the next one frees them */
+    assert_int_equal(epochReclaim(dom), 3);
+    assert_int_equal(_nFreed, 3);
+
+    /* synchronously, and on destroy */
+    epochRetire(dom, &objs[0], countFree);
+    epochSync(dom);
+    assert_int_equal(_nFreed, 4);
+    epochRetire(dom, &objs[1], countFree);
+    epochUnregister(thr);
+    epochDestroy(dom);
+    assert_int_equal(_nFreed, 5);
+}
+
+/** reads routes until stopped */
+static void *readRoutes(void *arg)
+{
+    epochThr_t *thr = epochRegister(_dom);
+    route_t *pos;
+    int n;
+
+    (void)arg;
+    while(!__atomic_load_n(&_stop, __ATOMIC_ACQUIRE)) {
+        epochEnter(thr);
+        n = 0;
+        listForEachRcu(pos, _routes) {
+            if(__atomic_load_n(&pos->dead, __ATOMIC_ACQUIRE))
+                __atomic_add_fetch(&_nDeadSeen, 1, __ATOMIC_RELAXED);
+            n++;
+        }
+        if(n != ROUTES || listFindRcu(_routes,, NUMCMP, ->dest, 3) == NULL)
+            __atomic_add_fetch(&_nDeadSeen, 1, __ATOMIC_RELAXED);
+        epochLeave(thr);
+    }
+    epochUnregister(thr);
+    return NULL;
+}
+
+/** tests readers never see freed routes while a writer replaces them */
+static void test_readers()
+{
+    pthread_t tids[READERS];
+    route_t *r, *old, *tmp;
+    int i;
+
+    _routes = _graves = NULL;
+    _nFreed = _nDeadSeen = 0;
+    _stop = 0;
+    assert_non_null(_dom = epochNew());
+    for(i = 0; i < ROUTES; i++) {
+        r = calloc(1, sizeof(*r));
+        r->dest = i;
+        listAddRcu(r, _routes);
+    }
+    for(i = 0; i < READERS; i++)
+        assert_int_equal(pthread_create(&tids[i], NULL, readRoutes, NULL), 0);
+
+    for(i = 0; i < UPDATES; i++) {
+        r = calloc(1, sizeof(*r));
+        r->dest = i % ROUTES;
+        old = listReplaceRcu(r, _routes,, NUMCMP, ->dest, r->dest);
+        assert_non_null(old);
+        epochRetire(_dom, old, bury);
+    }
+    __atomic_store_n(&_stop, 1, __ATOMIC_RELEASE);
+    for(i = 0; i < READERS; i++)
+        pthread_join(tids[i], NULL);
+
+    assert_int_equal(_nDeadSeen, 0);
+    epochSync(_dom);
+    assert_int_equal(_nFreed, UPDATES);
+
+    /* unlinked, then freed at once on destroy */
+    old = listUnlinkRcu(_routes,, NUMCMP, ->dest, 0);
+    assert_non_null(old);
+    assert_null(listFindRcu(_routes,, NUMCMP, ->dest, 0));
+    epochRetire(_dom, old, bury);
+    epochDestroy(_dom);
+    assert_int_equal(_nFreed, UPDATES + 1);
+
+    listForEachSafe(r, tmp, _graves, grave)
+        free(r);
+    listForEachSafe(r, tmp, _routes)
+        free(r);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_retire),  /* enter, leave, retire, reclaim, sync, destroy */
+        cmocka_unit_test(test_readers), /* addRcu, forEachRcu, findRcu, replaceRcu, unlinkRcu */
+    };
+
+    return cmocka_run_group_tests_name("Epoch tests", tests, NULL, NULL);
+}
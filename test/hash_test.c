@@ -0,0 +1,147 @@
+/**
+ * @file     hash_test.c
+ * @brief    intrusive hash table unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "hash.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+#define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
+#define NUMHASH(X)   ((unsigned long)(X) * 2654435761u)
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct entry_t entry_t;
+struct entry_t
+{
+    int key;
+    char name[16];
+    entry_t *LIST_LINK;
+    entry_t *LIST_LINK_(name);
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** hashes string (FNV-1a) */
+static unsigned long strHash(const char *s)
+{
+    unsigned long h = 2166136261u;
+
+    while(*s)
+        h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+/** tests additions, lookups and deletions across doublings */
+static void test_addFindDel()
+{
+    HASH_TABLE(entry_t) tbl = HASH_TABLE_INIT;
+    entry_t *arr = calloc(MANY, sizeof(*arr)), dup = { .key = 7 }, *pos;
+    unsigned long i, n;
+
+    assert_int_equal(hashInit(tbl, 3), 0);
+    assert_int_equal(tbl.nBkts, 4);
+    assert_null(hashFind(tbl,, NUMHASH, NUMCMP, ->key, 1));
+
+    for(i = 0; i < MANY; i++) {
+        arr[i].key = i;
+        assert_true(hashAddQ(&arr[i], tbl,, NUMHASH, NUMCMP, ->key));
+        /* some old and the new one found, even while doubling */
+        assert_ptr_equal(hashFind(tbl,, NUMHASH, NUMCMP, ->key, i), &arr[i]);
+        assert_ptr_equal(hashFind(tbl,, NUMHASH, NUMCMP, ->key, i/2),
+                         &arr[i/2]);
+    }
+    assert_int_equal(hashSize(tbl), MANY);
+    assert_true(tbl.nBkts >= MANY/2);
+    assert_false(hashAddQ(&dup, tbl,, NUMHASH, NUMCMP, ->key));
+    assert_null(hashFind(tbl,, NUMHASH, NUMCMP, ->key, MANY));
+
+    /* every other one removed */
+    for(i = 0; i < MANY; i += 2)
+        assert_ptr_equal(hashDel(tbl,, NUMHASH, NUMCMP, ->key, i), &arr[i]);
+    assert_null(hashDel(tbl,, NUMHASH, NUMCMP, ->key, 0));
+    assert_int_equal(hashSize(tbl), MANY/2);
+    for(i = 0; i < MANY; i++)
+        if(i % 2)
+            assert_ptr_equal(hashFind(tbl,, NUMHASH, NUMCMP, ->key, i),
+                             &arr[i]);
+        else
+            assert_null(hashFind(tbl,, NUMHASH, NUMCMP, ->key, i));
+
+    n = 0;
+    hashForEach(pos, i, tbl) {
+        assert_true(pos->key % 2);
+        n++;
+    }
+    assert_int_equal(n, MANY/2);
+
+    hashDestroy(tbl);
+    assert_null(tbl.bkts);
+    free(arr);
+}
+
+/** tests entries in two tables by distinct links and keys */
+static void test_twoTables()
+{
+    HASH_TABLE(entry_t) byKey = HASH_TABLE_INIT, byName = HASH_TABLE_INIT;
+    entry_t arr[1000], *pos;
+    unsigned long i, n = 0;
+
+    assert_int_equal(hashInit(byKey, 16), 0);
+    assert_int_equal(hashInit(byName, 16), 0);
+    for(i = 0; i < 1000; i++) {
+        arr[i].key = i;
+        snprintf(arr[i].name, sizeof(arr[i].name), "name%lu", i);
+        hashAdd(&arr[i], byKey,, NUMHASH, ->key);
+        assert_true(hashAddQ(&arr[i], byName, name, strHash, strcmp, ->name));
+    }
+    assert_false(hashAddQ(&arr[5], byName, name, strHash, strcmp, ->name));
+
+    assert_ptr_equal(hashFind(byName, name, strHash, strcmp, ->name,
+                              "name123"), &arr[123]);
+    assert_ptr_equal(hashDel(byName, name, strHash, strcmp, ->name,
+                             "name123"), &arr[123]);
+    assert_null(hashFind(byName, name, strHash, strcmp, ->name, "name123"));
+    assert_ptr_equal(hashFind(byKey,, NUMHASH, NUMCMP, ->key, 123),
+                     &arr[123]);
+
+    hashForEach(pos, i, byName, name)
+        n++;
+    assert_int_equal(n, 999);
+
+    hashDestroy(byKey);
+    hashDestroy(byName);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_addFindDel), /* init, addQ, find, del, forEach, destroy */
+        cmocka_unit_test(test_twoTables),  /* init, add, addQ, find, del, forEach */
+    };
+
+    return cmocka_run_group_tests_name("Hash table tests", tests, NULL, NULL);
+}
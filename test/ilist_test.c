@@ -0,0 +1,154 @@
+/**
+ * @file     ilist_test.c
+ * @brief    index-linked list unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "ilist.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 10000
+
+#define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct entry_t entry_t;
+struct entry_t
+{
+    int key;
+    uint32_t ILIST_LINK;
+    uint32_t ILIST_LINK_(odd);
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests add, iteration, find, findCache, move and reverse */
+static void test_ops()
+{
+    entry_t *base = malloc(sizeof(*base) * MANY), *pos;
+    uint32_t head = ILIST_NIL, odd = ILIST_NIL, tmp = ILIST_NIL;
+    int i, n;
+
+    assert_null(ilistFind(base, head,, NUMCMP, ->key, 0));
+    assert_null(ilistFindCache(base, head,, NUMCMP, ->key, 0));
+    for(i = 0; i < MANY; i++) {
+        base[i].key = i;
+        assert_int_equal(ilistAdd(&base[i], base, head), i);
+        if(i % 2)
+            ilistAdd(&base[i], base, odd, odd);
+    }
+    assert_int_equal(sizeof(entry_t), 3 * sizeof(uint32_t));
+
+    n = MANY;
+    ilistForEach(pos, base, head)
+        assert_int_equal(pos->key, --n);
+    assert_int_equal(n, 0);
+    n = 0;
+    ilistForEach(pos, base, odd, odd) {
+        assert_true(pos->key % 2);
+        n++;
+    }
+    assert_int_equal(n, MANY / 2);
+
+    pos = ilistFind(base, head,, NUMCMP, ->key, 123);
+    assert_ptr_equal(pos, &base[123]);
+    assert_ptr_equal(ilistFind(base, odd, odd, NUMCMP, ->key, 123), pos);
+    assert_null(ilistFind(base, odd, odd, NUMCMP, ->key, 124));
+
+    /* found one moved to head, others keep their order */
+    assert_ptr_equal(ilistFindCache(base, head,, NUMCMP, ->key, 123), pos);
+    assert_int_equal(head, 123);
+    assert_int_equal(ilistNext(base, pos)->key, MANY - 1);
+    assert_null(ilistFindCache(base, head,, NUMCMP, ->key, MANY));
+    n = 0;
+    ilistForEach(pos, base, head)
+        n++;
+    assert_int_equal(n, MANY);
+
+    /* moved over one by one, then back reversed */
+    while(ilistMove(base, tmp, head) != ILIST_NIL)
+        ;
+    assert_int_equal(head, ILIST_NIL);
+    assert_int_equal(tmp, 0);
+    assert_int_equal(ilistNext(base, &base[tmp])->key, 1);
+    ilistReverse(base, tmp);
+    assert_int_equal(tmp, 123);
+    ilistDel(base, tmp);
+    n = MANY;
+    ilistForEach(pos, base, tmp) {
+        if(--n == 123)
+            n--;
+        assert_int_equal(pos->key, n);
+    }
+    assert_int_equal(n, 0);
+    free(base);
+}
+
+/** tests deletion and lists kept over moving their base */
+static void test_relocate()
+{
+    entry_t *base = malloc(sizeof(*base) * MANY), *moved, *pos;
+    uint32_t head = ILIST_NIL;
+    int i, n;
+
+    for(i = 0; i < MANY; i++) {
+        base[i].key = i % 3;
+        ilistAdd(&base[i], base, head);
+    }
+    ilistDelMatch(base, head,, NUMCMP, ->key, 0);
+    n = 0;
+    ilistForEach(pos, base, head) {
+        assert_int_not_equal(pos->key, 0);
+        n++;
+    }
+    assert_int_equal(n, MANY - (MANY + 2) / 3);
+
+    /* copied elsewhere, list is the same */
+    moved = malloc(sizeof(*moved) * MANY);
+    memcpy(moved, base, sizeof(*base) * MANY);
+    memset(base, 0xff, sizeof(*base) * MANY);
+    free(base);
+    ilistDelMatch(moved, head,, NUMCMP, ->key, 1);
+    n = 0;
+    ilistForEach(pos, moved, head) {
+        assert_int_equal(pos->key, 2);
+        assert_int_equal(ilistIdx(moved, pos) % 3, 2);
+        n++;
+    }
+    assert_int_equal(n, MANY / 3);
+
+    ilistDelMatch(moved, head,, NUMCMP, ->key, 2);
+    assert_int_equal(head, ILIST_NIL);
+    assert_int_equal(ilistDel(moved, head), ILIST_NIL);
+    free(moved);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_ops),      /* add, forEach, find, findCache, move, reverse, del */
+        cmocka_unit_test(test_relocate), /* delMatch, idx over a moved base */
+    };
+
+    return cmocka_run_group_tests_name("Index list tests", tests, NULL, NULL);
+}
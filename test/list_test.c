@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include <cmocka.h>
 
 #include "list.h"
@@ -23,6 +24,10 @@
 #define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
 #define EL_N(Arr)    sizeof(Arr)/sizeof(Arr[0])
 
+/** number of producer threads and entries added by each */
+#define PRODUCERS    4
+#define PER_PRODUCER 100000
+
 
 /* ----- types ------------------------------------------------------------- */
 
@@ -36,6 +41,33 @@ struct entry_t
 };
 
 
+typedef struct sortEntry_t sortEntry_t;
+struct sortEntry_t
+{
+    int key;
+    int idx;
+    sortEntry_t *LIST_LINK;
+};
+
+
+typedef struct mpscEntry_t mpscEntry_t;
+struct mpscEntry_t
+{
+    int producer;
+    int seq;
+    mpscEntry_t *LIST_LINK;
+};
+
+
+typedef struct producer_t producer_t;
+struct producer_t
+{
+    int id;
+    mpscEntry_t *entries;
+    mpscEntry_t **head;
+};
+
+
 /* ----- globals ----------------------------------------------------------- */
 
 
@@ -331,6 +363,221 @@ static void test_findCache()
     assert_ptr_equal(head, &_entryArr[9]);
 }
 
+/** tests list descriptor operations */
+static void test_desc()
+{
+    LIST_DESC(entryDesc, entry_t) desc = LIST_DESC_INIT,
+                                  descOther = LIST_DESC_INIT;
+    entry_t *pos;
+    int i;
+
+    assert_true(listDescIsEmpty(desc));
+    assert_null(listDescDel(desc));
+    assert_null(listDescCat(desc, descOther, other));
+
+    /* append and prepend */
+    memset(_entryArr, 0, sizeof(_entryArr));
+    for(i = 1; i < EL_N(_entryArr); i++) {
+        _entryArr[i].i = i;
+        listDescAddTail(&_entryArr[i], desc);
+    }
+    listDescAdd(&_entryArr[0], desc);
+    assert_ptr_equal(desc.tail, &_entryArr[EL_N(_entryArr)-1]);
+    i = 0;
+    listForEach(pos, desc.head) {
+        assert_int_equal(i, pos->i);
+        i++;
+    }
+    assert_int_equal(i, EL_N(_entryArr));
+
+    /* pop head up to the last one, which takes the tail too */
+    for(i = 1; i < EL_N(_entryArr); i++)
+        assert_ptr_equal(listDescDel(desc), &_entryArr[i]);
+    assert_ptr_equal(desc.head, desc.tail);
+    assert_null(listDescDel(desc));
+    assert_null(desc.tail);
+
+    /* concatenate on the other link, into empty and non-empty target */
+    for(i = 0; i < 5; i++)
+        listDescAddTail(&_entryArr[i], descOther, other);
+    listDescCat(desc, descOther, other);
+    assert_true(listDescIsEmpty(descOther));
+    for(i = 5; i < EL_N(_entryArr); i++)
+        listDescAddTail(&_entryArr[i], descOther, other);
+    assert_ptr_equal(listDescCat(desc, descOther, other), &_entryArr[0]);
+    assert_ptr_equal(desc.tail, &_entryArr[EL_N(_entryArr)-1]);
+    i = 0;
+    listForEach(pos, desc.head, other) {
+        assert_int_equal(i, pos->i);
+        i++;
+    }
+    assert_int_equal(i, EL_N(_entryArr));
+
+    /* tail restored after head-only operation */
+    listReverse(desc.head, other);
+    assert_ptr_equal(listDescSetTail(desc, other), &_entryArr[0]);
+    listDescAddTail(&_entryArr[0], descOther, other);
+    assert_null(listDescSetTail(descOther, other)->LIST_LINK_(other));
+}
+
+
+/** checks list to be sorted by key, stable by index */
+static void checkSorted(sortEntry_t *head, int n)
+{
+    sortEntry_t *pos;
+    int i = 0;
+
+    listForEach(pos, head) {
+        i++;
+        if(!listIsLast(pos)) {
+            assert_true(pos->key <= listNext(pos)->key);
+            if(pos->key == listNext(pos)->key)
+                assert_true(pos->idx < listNext(pos)->idx);
+        }
+    }
+    assert_int_equal(i, n);
+}
+
+/** tests sorting and merging */
+static void test_sort()
+{
+    static sortEntry_t arr[1000];
+    sortEntry_t *head = NULL, *heads[5] = { NULL };
+    int n, i;
+
+    /* empty, then lists of every length up to a few runs */
+    assert_null(listSort(head,, NUMCMP, ->key));
+    for(n = 1; n <= 40; n++) {
+        head = NULL;
+        for(i = n-1; i >= 0; i--) {
+            arr[i].key = (i * 7) % 5;
+            arr[i].idx = i;
+            listAdd(&arr[i], head);
+        }
+        listSort(head,, NUMCMP, ->key);
+        checkSorted(head, n);
+    }
+
+    /* random keys with many duplicates */
+    head = NULL;
+    for(i = EL_N(arr)-1; i >= 0; i--) {
+        arr[i].key = rand() % 50;
+        arr[i].idx = i;
+        listAdd(&arr[i], head);
+    }
+    listSort(head,, NUMCMP, ->key);
+    checkSorted(head, EL_N(arr));
+
+    /* k sorted lists, indexes growing by list */
+    for(i = EL_N(arr)-1; i >= 0; i--) {
+        arr[i].key = i % 97;
+        arr[i].idx = i;
+        listAdd(&arr[i], heads[i * 5 / EL_N(arr)]);
+    }
+    for(i = 0; i < 5; i++)
+        listSort(heads[i],, NUMCMP, ->key);
+    assert_ptr_equal(listMergeK(heads, 5,, NUMCMP, ->key), heads[0]);
+    for(i = 1; i < 5; i++)
+        assert_null(heads[i]);
+    checkSorted(heads[0], EL_N(arr));
+
+    /* merge into empty and from empty */
+    head = NULL;
+    listMerge(head, heads[0],, NUMCMP, ->key);
+    assert_null(heads[0]);
+    listMerge(head, heads[1],, NUMCMP, ->key);
+    checkSorted(head, EL_N(arr));
+    assert_null(listMergeK(heads, 0,, NUMCMP, ->key));
+}
+
+/** tests prefetching iteration, find and deletion */
+static void test_prefetch()
+{
+    entry_t *head = NULL, *pos, *ahead;
+    int i, n;
+
+    /* for empty list, and for ones shorter than the distance */
+    listForEachPrefetch(pos, ahead, head)
+        fail();
+    assert_null(listFindPrefetch(head,, NUMCMP, ->i, 0));
+    memset(_entryArr, 0, sizeof(_entryArr));
+    for(i = 0; i < 2; i++) {
+        _entryArr[i].i = i;
+        listAdd(&_entryArr[i], head);
+    }
+    assert_ptr_equal(listFindPrefetch(head,, NUMCMP, ->i, 0), &_entryArr[0]);
+
+    /* the same order as without prefetching */
+    for(; i < EL_N(_entryArr); i++) {
+        _entryArr[i].i = i;
+        listAdd(&_entryArr[i], head);
+    }
+    assert_true(EL_N(_entryArr) > LIST_PREFETCH_DIST);
+    n = EL_N(_entryArr);
+    listForEachPrefetch(pos, ahead, head)
+        assert_int_equal(pos->i, --n);
+    assert_int_equal(n, 0);
+    assert_ptr_equal(listFindPrefetch(head,, NUMCMP, ->i, 3), &_entryArr[3]);
+    assert_null(listFindPrefetch(head,, NUMCMP, ->i, 11));
+
+    /* even ones deleted, first and last included */
+    for(i = 0; i < EL_N(_entryArr); i += 2)
+        listDelMatchPrefetch(head,, NUMCMP, ->i, i);
+    n = 0;
+    listForEach(pos, head) {
+        assert_true(pos->i % 2);
+        n++;
+    }
+    assert_int_equal(n, EL_N(_entryArr) / 2);
+}
+
+/** adds entries of a producer to the shared list */
+static void *produce(void *arg)
+{
+    producer_t *p = arg;
+    int i;
+
+    for(i = 0; i < PER_PRODUCER; i++) {
+        p->entries[i].producer = p->id;
+        p->entries[i].seq = i;
+        listAddAtomic(&p->entries[i], *p->head);
+    }
+    return NULL;
+}
+
+/** tests atomic additions by many producers drained by one consumer */
+static void test_atomic()
+{
+    mpscEntry_t *head = NULL, *taken, *pos;
+    producer_t prods[PRODUCERS];
+    pthread_t tids[PRODUCERS];
+    int next[PRODUCERS] = { 0 }, n = 0, i;
+
+    assert_null(listTakeAll(head));
+    for(i = 0; i < PRODUCERS; i++) {
+        prods[i].id = i;
+        prods[i].entries = calloc(PER_PRODUCER, sizeof(mpscEntry_t));
+        prods[i].head = &head;
+        assert_int_equal(pthread_create(&tids[i], NULL, produce, &prods[i]),
+                         0);
+    }
+
+    /* each entry taken once, in order of addition by its producer */
+    while(n < PRODUCERS * PER_PRODUCER) {
+        taken = listTakeAllFifo(head);
+        listForEach(pos, taken) {
+            assert_int_equal(pos->seq, next[pos->producer]);
+            next[pos->producer]++;
+            n++;
+        }
+    }
+    for(i = 0; i < PRODUCERS; i++) {
+        pthread_join(tids[i], NULL);
+        assert_int_equal(next[i], PER_PRODUCER);
+        free(prods[i].entries);
+    }
+    assert_null(head);
+}
 
 int main(void) {
     const struct CMUnitTest tests[] = {
@@ -340,6 +587,10 @@ int main(void) {
         cmocka_unit_test(test_move),     /* add, move, forEach */
         cmocka_unit_test(test_move2),    /* add, move, forEach */
         cmocka_unit_test(test_findCache),/* add, findCache, forEach */
+        cmocka_unit_test(test_sort),     /* sort, merge, mergeK, forEach */
+        cmocka_unit_test(test_desc),     /* descAdd, descAddTail, descDel, descCat, descSetTail */
+        cmocka_unit_test(test_atomic),   /* addAtomic, takeAll, takeAllFifo */
+        cmocka_unit_test(test_prefetch), /* forEachPrefetch, findPrefetch, delMatchPrefetch */
         //cmocka_unit_test_setup_teardown(test_Xxx, setup, teardown),
     };
 
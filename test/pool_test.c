@@ -0,0 +1,155 @@
+/**
+ * @file     pool_test.c
+ * @brief    fixed-size object pool unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "pool.h"
+#include "stk.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct node_t node_t;
+struct node_t
+{
+    int i;
+    node_t *LIST_LINK;
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests list nodes allocated from and freed to a pool */
+static void test_allocFree()
+{
+    pool_t *p = poolNew(sizeof(node_t), 0, 100), *huge;
+    node_t *head = NULL, *node, *last = NULL;
+    int i;
+
+    assert_null(poolNew(8, 3, 10));
+    assert_null(poolNew(8, 8, 0));
+    assert_non_null(p);
+
+    /* slab size wrapping around */
+    huge = poolNew(SIZE_MAX / 4, 0, 8);
+    assert_null(poolAlloc(huge));
+    assert_int_equal(huge->nUsed, 0);
+    poolDestroy(huge);
+
+    for(i = 0; i < MANY; i++) {
+        node = poolAlloc(p);
+        node->i = i;
+        listAdd(node, head);
+    }
+    assert_int_equal(p->nUsed, MANY);
+
+    for(i = MANY; (node = head); i--) {
+        assert_int_equal(node->i, i-1);
+        listDel(head);
+        poolFree(p, last = node);
+    }
+    assert_int_equal(p->nUsed, 0);
+
+    /* last freed first reused */
+    node = poolAlloc(p);
+    assert_ptr_equal(node, last);
+    poolFree(p, node);
+
+    poolDestroy(p);
+
+} /* test_allocFree() */
+
+
+/** tests alignment and bulk operations */
+static void test_alignBulk()
+{
+    pool_t *p = poolNew(24, 64, 7);
+    void *objs[50];
+    size_t i;
+
+    assert_int_equal(poolAllocBulk(p, objs, 50), 50);
+    for(i = 0; i < 50; i++) {
+        assert_int_equal((uintptr_t)objs[i] % 64, 0);
+        memset(objs[i], 0xff, 24);
+    }
+    assert_int_equal(p->nUsed, 50);
+    poolFreeBulk(p, objs, 50);
+    assert_int_equal(p->nUsed, 0);
+    poolFreeBulk(p, objs, 0);
+
+    assert_ptr_equal(poolAlloc(p), objs[0]);
+    assert_ptr_equal(poolAlloc(p), objs[1]);
+    poolDestroy(p);
+
+} /* test_alignBulk() */
+
+
+/** tests stacks sharing a pool of blocks */
+static void test_stkBlocks()
+{
+    pool_t *small = poolNew(sizeof(stkBlk_t), 0, 1);
+    pool_t *p = poolNew(STK_BLK_BYTES(32), 0, 16);
+    stk_t *s = stkNewPool(p), *s2 = stkNewPool(p);
+    size_t used;
+    int i;
+
+    /* no room for an element */
+    assert_null(stkNewPool(small));
+    poolDestroy(small);
+
+    assert_int_equal(s->blkSz, 32);
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s, i);
+    used = p->nUsed;
+    assert_int_equal(used, (MANY+31)/32);
+    for(i = 0; i < MANY; i++)
+        stkPop(s);
+    stkTrim(s);
+    assert_int_equal(p->nUsed, 0);
+
+    /* taken over by the other stack */
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s2, i);
+    assert_int_equal(p->nUsed, used);
+    assert_int_equal(stkPeek(s2, MANY-1)->var.i, 0);
+
+    stkDestroy(s);
+    stkDestroy(s2);
+    assert_int_equal(p->nUsed, 0);
+    poolDestroy(p);
+
+} /* test_stkBlocks() */
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_allocFree), /* new, alloc, free, destroy */
+        cmocka_unit_test(test_alignBulk), /* new, allocBulk, freeBulk, alloc */
+        cmocka_unit_test(test_stkBlocks), /* new, stkNewPool, alloc, free */
+    };
+
+    return cmocka_run_group_tests_name("Pool tests", tests, NULL, NULL);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file     skip_test.c
+ * @brief    intrusive skip list unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "skip.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+#define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct entry_t entry_t;
+struct entry_t
+{
+    int key;
+    int seq;
+    SKIP_LINKS(entry_t,);
+    SKIP_LINKS(entry_t, other);
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests additions in random order, lookups, ranges and deletions */
+static void test_addFindDel()
+{
+    SKIP_LIST(entry_t) sl = SKIP_LIST_INIT;
+    entry_t *arr = calloc(MANY, sizeof(*arr)), dup = { .key = 7 }, *pos;
+    int i, j, tmp, n, prev;
+
+    for(i = 0; i < MANY; i++)
+        arr[i].key = 2 * i;
+    for(i = MANY - 1; i > 0; i--) {
+        j = rand() % (i + 1);
+        tmp = arr[i].key; arr[i].key = arr[j].key; arr[j].key = tmp;
+    }
+
+    assert_null(skipFirst(sl));
+    assert_null(skipFind(sl,, NUMCMP, ->key, 0));
+    for(i = 0; i < MANY; i++)
+        assert_true(skipAddQ(&arr[i], sl,, NUMCMP, ->key));
+    assert_int_equal(skipSize(sl), MANY);
+    assert_true(sl.lvl > 1 && sl.lvl <= SKIP_LEVELS);
+    dup.key = arr[MANY/2].key;
+    assert_false(skipAddQ(&dup, sl,, NUMCMP, ->key));
+
+    /* in order, every key found, none in between */
+    n = 0;
+    skipForEach(pos, sl)
+        assert_int_equal(pos->key, 2 * n++);
+    assert_int_equal(n, MANY);
+    for(i = 0; i < MANY; i++) {
+        pos = skipFind(sl,, NUMCMP, ->key, 2 * i);
+        assert_non_null(pos);
+        assert_int_equal(pos->key, 2 * i);
+        assert_null(skipFind(sl,, NUMCMP, ->key, 2 * i + 1));
+    }
+    pos = skipSeek(sl,, NUMCMP, ->key, 101);
+    assert_int_equal(pos->key, 102);
+    assert_null(skipSeek(sl,, NUMCMP, ->key, 2 * MANY));
+
+    /* range of odd bounds */
+    n = 0;
+    skipForEachRange(pos, sl,, NUMCMP, ->key, 999, 2001)
+        assert_int_equal(pos->key, 1000 + 2 * n++);
+    assert_int_equal(n, 501);
+
+    /* every other one removed */
+    for(i = 0; i < MANY; i += 2) {
+        pos = skipDel(sl,, NUMCMP, ->key, 2 * i);
+        assert_non_null(pos);
+        assert_int_equal(pos->key, 2 * i);
+    }
+    assert_null(skipDel(sl,, NUMCMP, ->key, 0));
+    assert_int_equal(skipSize(sl), MANY/2);
+    for(i = 0; i < MANY; i++)
+        if(i % 2)
+            assert_non_null(skipFind(sl,, NUMCMP, ->key, 2 * i));
+        else
+            assert_null(skipFind(sl,, NUMCMP, ->key, 2 * i));
+
+    /* drained from the front in order */
+    prev = -1;
+    while((pos = skipDelFirst(sl))) {
+        assert_true(pos->key > prev);
+        prev = pos->key;
+    }
+    assert_int_equal(skipSize(sl), 0);
+    assert_int_equal(sl.lvl, 1);
+    free(arr);
+}
+
+/** tests equal keys kept in order of addition, on two lists */
+static void test_dupTwoLists()
+{
+    SKIP_LIST(entry_t) byKey = SKIP_LIST_INIT, bySeq = SKIP_LIST_INIT;
+    entry_t arr[1000], *pos;
+    int i, n = 0, seq = -1;
+
+    for(i = 0; i < 1000; i++) {
+        arr[i].key = i % 10;
+        arr[i].seq = 999 - i;
+        skipAdd(&arr[i], byKey,, NUMCMP, ->key);
+        skipAdd(&arr[i], bySeq, other, NUMCMP, ->seq);
+    }
+
+    /* stable among equal keys */
+    skipForEach(pos, byKey) {
+        assert_int_equal(pos->key, n / 100);
+        if(n % 100)
+            assert_true(pos->seq < seq);
+        seq = pos->seq;
+        n++;
+    }
+    assert_int_equal(n, 1000);
+    n = 0;
+    skipForEach(pos, bySeq, other)
+        assert_int_equal(pos->seq, n++);
+
+    /* earliest added one of equal keys removed first */
+    assert_ptr_equal(skipDel(byKey,, NUMCMP, ->key, 3), &arr[3]);
+    assert_ptr_equal(skipDel(byKey,, NUMCMP, ->key, 3), &arr[13]);
+    assert_ptr_equal(skipFind(byKey,, NUMCMP, ->key, 3), &arr[23]);
+    assert_ptr_equal(skipDelFirst(bySeq, other), &arr[999]);
+    assert_ptr_equal(skipFirst(bySeq), &arr[998]);
+    assert_int_equal(skipSize(byKey), 998);
+    assert_int_equal(skipSize(bySeq), 999);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_addFindDel),  /* addQ, find, seek, range, del, delFirst */
+        cmocka_unit_test(test_dupTwoLists), /* add, forEach, del, delFirst */
+    };
+
+    return cmocka_run_group_tests_name("Skip list tests", tests, NULL, NULL);
+}
@@ -12,6 +12,7 @@
 #include <setjmp.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <cmocka.h>
 
 #include "stk.h"
@@ -141,6 +142,593 @@ static void test_manyPushStrs()
 } /* test_manyPushStrs() */
 
 
+/** tests depth query and peeks across block boundaries */
+static void test_sizePeek()
+{
+    stk_t *s = stkNew(32);
+    int i;
+
+    assert_int_equal(stkSize(s), 0);
+    assert_null(stkPeek(s, 0));
+
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s, i);
+    assert_int_equal(stkSize(s), MANY);
+
+    for(i = 0; i < MANY; i += 7)
+        assert_int_equal(stkPeek(s, i)->var.i, MANY-1 - i);
+    assert_int_equal(stkPeek(s, MANY-1)->var.i, 0);
+    assert_null(stkPeek(s, MANY));
+
+    /* pop down into lower blocks, then push back onto spare ones */
+    for(i = 0; i < 100; i++)
+        stkPop(s);
+    assert_int_equal(stkSize(s), MANY-100);
+    assert_int_equal(stkValInt(s), MANY-101);
+    assert_int_equal(stkPeek(s, 40)->var.i, MANY-141);
+    stkPushInt(s, -1);
+    assert_int_equal(stkPeek(s, 1)->var.i, MANY-101);
+
+    stkClear(s);
+    assert_int_equal(stkSize(s), 0);
+    assert_null(stkPeek(s, 0));
+    stkPushChr(s, 'x');
+    assert_int_equal(stkSize(s), 1);
+    assert_int_equal(stkPeek(s, 0)->var.c, 'x');
+
+    stkDestroy(s);
+
+} /* test_sizePeek() */
+
+
+/** tests non-destructive iteration in both directions */
+static void test_iter()
+{
+    stk_t *s = stkNew(32);
+    stkIter_t it;
+    stkEl_t *el;
+    int i;
+
+    stkForEach(el, it, s)
+        fail();
+    stkForEachRev(el, it, s)
+        fail();
+
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s, i);
+    for(i = 0; i < 50; i++) /* leave last block partially filled */
+        stkPop(s);
+
+    i = MANY-50;
+    stkForEach(el, it, s)
+        assert_int_equal(el->var.i, --i);
+    assert_int_equal(i, 0);
+
+    stkForEachRev(el, it, s)
+        assert_int_equal(el->var.i, i++);
+    assert_int_equal(i, MANY-50);
+    assert_int_equal(stkSize(s), MANY-50);
+
+    stkDestroy(s);
+
+} /* test_iter() */
+
+
+/** sums the integers of a run */
+static void sumMap(const stkEl_t *els, size_t n, void *part, void *arg)
+{
+    size_t i;
+
+    (void)arg;
+    for(i = 0; i < n; i++)
+        *(long long *)part += els[i].var.i;
+}
+
+/** adds up partial sums */
+static void sumReduce(void *acc, const void *part, void *arg)
+{
+    (void)arg;
+    *(long long *)acc += *(const long long *)part;
+}
+
+/** tests aggregation on several threads */
+static void test_mapReduce()
+{
+    stk_t *s = stkNew(100);
+    long long sum;
+    unsigned n;
+    int i;
+
+    sum = 0;
+    assert_int_equal(stkMapReduce(s, 4, sumMap, sumReduce,
+                                  &sum, sizeof(sum), NULL), 0);
+    assert_int_equal(sum, 0);
+
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s, i);
+    stkPop(s);
+
+    for(n = 0; n <= 8; n++) {
+        sum = 0;
+        assert_int_equal(stkMapReduce(s, n, sumMap, sumReduce,
+                                      &sum, sizeof(sum), NULL), 0);
+        assert_int_equal(sum, (long long)(MANY-1) * (MANY-2) / 2);
+    }
+
+    stkDestroy(s);
+
+} /* test_mapReduce() */
+
+
+/** tests search and count on every available SIMD level */
+static void test_find()
+{
+    stk_t *s = stkNew(33);
+    int level, max = stkSetSimd(-1);
+    int i;
+
+    for(i = 0; i < MANY; i++)
+        switch(i % 5) {
+            case 0: stkPushInt(s, i); break;
+            case 1: stkPushDbl(s, i); break;
+            case 2: stkPushChr(s, i % 128); break;
+            case 3: stkPushPtr(s, (char *)s + i); break;
+            case 4: if(i % 1000 == 4) stkPushStr(s, "str");
+                    else stkPushInt(s, -i);
+                    break;
+        }
+
+    for(level = STK_SIMD_NONE; level <= max; level++) {
+        assert_int_equal(stkSetSimd(level), level);
+
+        assert_int_equal(stkCountType(s, 'i'), MANY/5 * 2 - MANY/1000);
+        assert_int_equal(stkCountType(s, 'd'), MANY/5);
+        assert_int_equal(stkCountType(s, 's'), MANY/1000);
+        assert_int_equal(stkCountType(s, 'x'), 0);
+
+        assert_int_equal(stkFindInt(s, 0)->var.i, 0);
+        assert_int_equal(stkFindInt(s, MANY-5)->var.i, MANY-5);
+        assert_int_equal(stkFindInt(s, -(MANY-1))->var.i, -(MANY-1));
+        assert_null(stkFindInt(s, 1)); /* double there */
+        assert_true(stkFindDbl(s, 11)->var.d == 11.0);
+        assert_null(stkFindDbl(s, 10));
+        assert_ptr_equal(stkFindPtr(s, (char *)s + 13)->var.p, (char *)s + 13);
+        assert_null(stkFindPtr(s, (char *)s + 14));
+        for(i = MANY-1; i % 5 != 2 || i % 128 != 7; i--)
+            ;
+        assert_ptr_equal(stkFindChr(s, 7), stkPeek(s, MANY-1 - i));
+        assert_ptr_equal(stkFindStr(s, "str"), stkPeek(s, MANY-1 - (MANY-996)));
+        assert_null(stkFindStr(s, "other"));
+    }
+    stkSetSimd(-1);
+
+    stkClear(s);
+    assert_int_equal(stkCountType(s, 'i'), 0);
+    assert_null(stkFindInt(s, 0));
+    stkDestroy(s);
+
+    /* runs long enough for partial counts to add up past a byte */
+    s = stkNew(MANY);
+    for(i = 0; i < MANY - 3; i++)
+        stkPushInt(s, i);
+    for(level = STK_SIMD_NONE; level <= max; level++) {
+        stkSetSimd(level);
+        assert_int_equal(stkCountType(s, 'i'), MANY - 3);
+    }
+    stkSetSimd(-1);
+    stkDestroy(s);
+
+} /* test_find() */
+
+
+/** tests searches on every SIMD level look at values only, not at the
+ *  type tag and padding after them */
+static void test_findTag()
+{
+    stk_t *s = stkNew(8);
+    int level, max = stkSetSimd(-1);
+    long long bits = 'd';
+    stkEl_t *el;
+    double d;
+    int i;
+
+    /* padding zeroed, so the upper half is just the tag */
+    for(i = 0; i < 9; i++) {
+        el = stkPushDbl(s, i);
+        memset(&el->type + 1, 0, sizeof(*el) - offsetof(stkEl_t, type) - 1);
+    }
+    memcpy(&d, &bits, sizeof(d));
+
+    for(level = STK_SIMD_NONE; level <= max; level++) {
+        stkSetSimd(level);
+        assert_null(stkFindDbl(s, d));
+        assert_null(stkFindInt(s, 'd'));
+        assert_true(stkFindDbl(s, 0)->var.d == 0.0);
+    }
+    stkSetSimd(-1);
+
+    stkDestroy(s);
+
+} /* test_findTag() */
+
+
+/** tests statistics (collected only if built with STK_STATS) */
+static void test_stats()
+{
+    stk_t *s = stkNew(32);
+    stkStats_t st;
+    size_t n;
+    int i;
+
+#ifdef STK_STATS
+    assert_int_equal(stkStatsSample(s, 16), 0);
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s, i);
+    for(i = 0; i < MANY/2; i++)
+        stkPop(s);
+    for(i = 0; i < MANY/4; i++)
+        stkPushStr(s, "0123456");
+
+    assert_int_equal(stkStats(s, &st), 0);
+    assert_int_equal(st.pushes, MANY + MANY/4);
+    assert_int_equal(st.pops, MANY/2);
+    assert_int_equal(st.hwm, MANY);
+    assert_int_equal(st.blkAllocs, (MANY+31)/32);
+    assert_int_equal(st.blkReuses, (MANY/4)/32);
+    assert_int_equal(st.blkHits + st.blkReuses + st.blkAllocs, st.pushes);
+    assert_int_equal(st.strBytes, MANY/4 * 8);
+    assert_int_equal(st.bytesLive,
+                     stkSize(s) * sizeof(stkEl_t) + st.strBytes);
+    assert_true(st.bytesReserved >= (MANY+31)/32 * 32 * sizeof(stkEl_t));
+
+    for(i = 0, n = 0; i < STK_STATS_BUCKETS; i++)
+        n += st.latency[i];
+    assert_int_equal(n, (st.pushes + st.pops) / 16);
+
+    stkClear(s);
+    assert_int_equal(stkStats(s, &st), 0);
+    assert_int_equal(st.strBytes, 0);
+#else
+    assert_int_equal(stkStats(s, &st), -1);
+    assert_int_equal(stkStatsSample(s, 16), -1);
+    (void)n; (void)i;
+#endif
+
+    stkDestroy(s);
+
+} /* test_stats() */
+
+
+/** tests frames pushed and popped in one go, across blocks */
+static void test_frames()
+{
+    stk_t *s = stkNew(8);
+    stkVar_t vals[5] = { { .i = 1 }, { .d = 2.5 }, { .c = '3' },
+                         { .s = "four" }, { .p = NULL } };
+    stkIter_t it;
+    stkEl_t *el;
+    int i;
+
+    assert_null(stkPopFrame(s));
+    assert_null(stkPushFrame(s, 8, "iiiiiiii", NULL)); /* no room for header */
+    assert_null(stkPushFrame(s, 1, "x", NULL));
+    assert_true(stkIsEmpty(s));
+
+    /* ints only, frame does not fit into the rest of the first block */
+    for(i = 0; i < 5; i++)
+        stkPushInt(s, i);
+    el = stkPushFrame(s, 4, "idcp", NULL);
+    assert_non_null(el);
+    assert_ptr_equal(el, stkFrameEl(s, 0));
+    assert_int_equal(stkSize(s), 10);
+    assert_true(stkIsPtr(s));
+    assert_int_equal(stkFrameEl(s, 0)->var.i, 0);
+    stkFrameEl(s, 0)->var.i = 42;
+
+    /* nested frame and plain pushes above, crossing blocks */
+    el = stkPushFrame(s, 5, "idcsp", vals);
+    assert_int_equal(el[0].var.i, 1);
+    assert_true(el[1].var.d == 2.5);
+    assert_string_equal(stkFrameEl(s, 3)->var.s, "four");
+    for(i = 0; i < 20; i++)
+        stkPushInt(s, 100 + i);
+    assert_int_equal(stkSize(s), 36);
+    assert_int_equal(stkPeek(s, 35)->var.i, 0);
+    assert_int_equal(stkPeek(s, 22)->type, 'c');
+    assert_int_equal(stkPeek(s, 29)->var.i, 42);
+    i = 0;
+    stkForEachRev(el, it, s)
+        i++;
+    assert_int_equal(i, 36);
+    assert_int_equal(stkCountType(s, 'f'), 2);
+
+    /* with a string, then without one */
+    stkPopFrame(s);
+    assert_int_equal(stkSize(s), 10);
+    assert_int_equal(stkFrameEl(s, 0)->var.i, 42);
+    for(i = 0; i < 20; i++)
+        stkPushInt(s, i);
+    stkPopFrame(s);
+    assert_int_equal(stkValInt(s), 4);
+    assert_int_equal(stkSize(s), 5);
+    assert_null(s->frame);
+
+    /* header popped by plain pops */
+    stkPushFrame(s, 2, "ii", NULL);
+    stkPop(s);
+    stkPop(s);
+    stkPop(s);
+    assert_null(s->frame);
+    assert_int_equal(stkValInt(s), 4);
+
+    stkPushFrame(s, 1, "s", vals + 3);
+    stkDestroy(s);
+
+} /* test_frames() */
+
+
+/** tests reuse of popped string buffers */
+static void test_strRecycle()
+{
+    stk_t *s = stkNew(32);
+    char *buf;
+    int i;
+
+    stkPushStr(s, "1");
+    assert_int_equal(stkStrRecycle(s, 64), -1);
+    stkPop(s);
+    stkPushInt(s, 1);
+    assert_int_equal(stkStrRecycle(s, 64), 0);
+    stkPop(s);
+
+    /* same size class, same buffer */
+    stkPushStr(s, "0123456789");
+    buf = stkValStr(s);
+    stkPop(s);
+    stkPushStr(s, "abc");
+    assert_ptr_equal(stkValStr(s), buf);
+    assert_string_equal(stkValStr(s), "abc");
+    stkPop(s);
+
+    /* beyond budget (64 bytes: four of 16) freed for real */
+    for(i = 0; i < MANY; i++)
+        stkPushStr(s, "0123456789");
+    stkClear(s);
+    for(i = 0; i < 4; i++)
+        stkPushStr(s, "x");
+    assert_string_equal(stkValStr(s), "x");
+
+    /* long strings are not recycled */
+    buf = calloc(1, 100000);
+    memset(buf, 'y', 99999);
+    stkPushStr(s, buf);
+    stkPop(s);
+    free(buf);
+
+    stkTrim(s);
+    stkClear(s);
+    stkTrim(s);
+    assert_true(stkIsEmpty(s));
+    stkPushStr(s, "after trim");
+    assert_string_equal(stkValStr(s), "after trim");
+    stkPop(s);
+
+    assert_int_equal(stkStrRecycle(s, 0), 0);
+    stkPushStr(s, "0123456789");
+    stkDestroy(s);
+
+} /* test_strRecycle() */
+
+
+/** tests automatic block sizing on shallow and on deep usage */
+static void test_tune()
+{
+    pool_t *p = poolNew(STK_BLK_BYTES(8), 0, 1);
+    stk_t *s = stkNew(4096), *sp = stkNewPool(p);
+    stkTuneStats_t st;
+    const char types[] = "iiiiiiiiii";
+    int i, j;
+
+    assert_int_equal(stkTuneStats(s, &st), -1);
+    assert_int_equal(stkTune(s, 0, 16), -1);
+    assert_int_equal(stkTune(s, 32, 16), -1);
+    assert_int_equal(stkTune(sp, 1, 8), -1);
+    assert_int_equal(stkTune(s, 4, 1 << 16), 0);
+
+    /* shallow episodes, block size and blocks cut down */
+    for(j = 0; j < 4; j++) {
+        for(i = 0; i < 3; i++)
+            stkPushInt(s, i);
+        assert_int_equal(stkValInt(s), 2);
+        while(stkPop(s))
+            ;
+    }
+    assert_int_equal(stkTuneStats(s, &st), 0);
+    assert_int_equal(st.episodes, 4);
+    assert_int_equal(st.shrinks, 1);
+    assert_int_equal(st.releases, 1);
+    assert_true(st.blkSz < 4096 && st.blkSz >= 6);
+    assert_int_equal(s->nBlks, 0);
+    stkPushInt(s, 0);
+    assert_int_equal(s->blks->cap, st.blkSz);
+
+    /* deep episode, few allocations as block size grows */
+    for(i = 1; i < MANY; i++)
+        stkPushInt(s, i);
+    for(i = 0; i < MANY; i++)
+        assert_int_equal(stkPeek(s, i)->var.i, MANY-1-i);
+    stkTuneStats(s, &st);
+    assert_true(st.allocs < 16);
+    assert_true(st.grows >= 8);
+    assert_true(st.peak >= MANY && st.peak <= 2*MANY);
+
+    /* frame beyond the first watermark */
+    stkClear(s);
+    assert_non_null(stkPushFrame(s, 10, types, NULL));
+    stkFrameEl(s, 9)->var.i = 9;
+    stkPushInt(s, 10);
+    assert_int_equal(stkPeek(s, 1)->var.i, 9);
+    assert_int_equal(stkSize(s), 12);
+    stkPopFrame(s);
+    assert_true(stkIsEmpty(s));
+
+    assert_int_equal(stkTune(s, 0, 0), 0);
+    assert_int_equal(stkTuneStats(s, &st), -1);
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s, i);
+    assert_int_equal(stkSize(s), MANY);
+    stkDestroy(s);
+    stkDestroy(sp);
+    poolDestroy(p);
+
+} /* test_tune() */
+
+
+/** tests frames not fitting in the empty bottom block of a tuned stack */
+static void test_tuneFrames()
+{
+    stk_t *s = stkNew(4);
+    stkIter_t it;
+    stkEl_t *el;
+    const char types[] = "iiiiiiiiiii", bad[] = "iiiiiixiiii";
+    int i, n;
+
+    /* bottom block of 4 kept, blocks of 64 allocated above it */
+    stkPushInt(s, 0);
+    stkPop(s);
+    assert_int_equal(stkTune(s, 64, 64), 0);
+    assert_non_null(el = stkPushFrame(s, 11, types, NULL));
+    for(i = 0; i < 11; i++)
+        el[i].var.i = i;
+    assert_int_equal(stkSize(s), 12);
+    assert_int_equal(s->blks->cap, 64);
+    n = 0;
+    stkForEachRev(el, it, s)
+        n++;
+    assert_int_equal(n, 12);
+    assert_int_equal(stkPeek(s, 11)->type, 'f');
+    stkPopFrame(s);
+    assert_int_equal(stkSize(s), 0);
+    assert_true(stkIsEmpty(s));
+    stkPushInt(s, 1);
+    stkPop(s);
+    assert_true(stkIsEmpty(s));
+    stkDestroy(s);
+
+    /* failed, left as it was */
+    s = stkNew(4);
+    stkPushInt(s, 0);
+    stkPop(s);
+    assert_int_equal(stkTune(s, 64, 64), 0);
+    assert_null(stkPushFrame(s, 11, bad, NULL));
+    assert_null(s->frame);
+    assert_int_equal(stkSize(s), 0);
+    assert_true(stkIsEmpty(s));
+    stkPushInt(s, 1);
+    assert_int_equal(stkSize(s), 1);
+    stkPop(s);
+    assert_int_equal(stkSize(s), 0);
+    assert_true(stkIsEmpty(s));
+
+    /* failed above elements, back to their block */
+    for(i = 0; i < 60; i++)
+        stkPushInt(s, i);
+    assert_null(stkPushFrame(s, 11, bad, NULL));
+    assert_int_equal(stkSize(s), 60);
+    assert_int_equal(stkValInt(s), 59);
+    for(i = 59; i >= 0; i--, stkPop(s))
+        assert_int_equal(stkValInt(s), i);
+    assert_true(stkIsEmpty(s));
+    stkDestroy(s);
+
+} /* test_tuneFrames() */
+
+
+/** tests borrowing top elements in place and releasing them at once */
+static void test_span()
+{
+    stk_t *s = stkNew(8);
+    stkSpan_t span;
+    stkRun_t *last;
+    stkVar_t vals[2];
+    int got[MANY], i, n;
+    size_t k, j;
+
+    assert_int_equal(stkBorrowSpan(s, 5, &span), 0);
+    assert_null(stkReleaseSpan(s, &span));
+
+    for(i = 0; i < 20; i++)
+        stkPushInt(s, i);
+    assert_int_equal(stkBorrowSpan(s, 12, &span), 12);
+    assert_int_equal(span.nRuns, 2);
+    assert_int_equal(span.runs[0].n, 8);
+    assert_int_equal(span.runs[1].n, 4);
+    for(k = 0, n = 0; k < span.nRuns; k++)
+        for(j = 0; j < span.runs[k].n; j++)
+            got[n++] = span.runs[k].els[j].var.i;
+    for(i = 0; i < 12; i++)
+        assert_int_equal(got[i], 8+i);
+    assert_int_equal(stkReleaseSpan(s, &span)->var.i, 7);
+    assert_int_equal(stkSize(s), 8);
+
+    /* drained in a few borrows, as runs are limited */
+    for(i = 8; i < MANY; i++)
+        stkPushInt(s, i);
+    for(n = MANY; stkBorrowSpan(s, MANY, &span); n -= span.n) {
+        assert_true(span.nRuns <= STK_SPAN_RUNS);
+        last = &span.runs[span.nRuns-1];
+        assert_int_equal(last->els[last->n-1].var.i, n-1);
+        assert_int_equal(span.runs[0].els[0].var.i, n - (int)span.n);
+        stkReleaseSpan(s, &span);
+    }
+    assert_int_equal(n, 0);
+    assert_true(stkIsEmpty(s));
+
+    /* strings freed or taken over, frames left */
+    stkPushStr(s, "below");
+    vals[0].s = "in frame";
+    vals[1].i = 1;
+    for(i = 0; i < 3; i++)
+        stkPushFrame(s, 2, "si", vals);
+    assert_int_equal(stkBorrowSpan(s, 7, &span), 7);
+    last = &span.runs[span.nRuns-1];
+    free(last->els[last->n-2].var.s);
+    last->els[last->n-2].type = 'p';
+    stkReleaseSpan(s, &span);
+    assert_int_equal(stkSize(s), 3);
+    assert_string_equal(stkPeek(s, 2)->var.s, "below");
+    assert_ptr_equal(s->frame, stkPeek(s, 1));
+    assert_int_equal(stkBorrowSpan(s, 3, &span), 3);
+    stkReleaseSpan(s, &span);
+    assert_null(s->frame);
+    stkPushFrame(s, 2, "si", vals);
+    assert_string_equal(stkFrameEl(s, 0)->var.s, "in frame");
+
+    /* taken over strings not counted, so none held once empty */
+    stkPushStr(s, "taken");
+    assert_int_equal(stkBorrowSpan(s, 4, &span), 4);
+    last = &span.runs[span.nRuns-1];
+    free(last->els[last->n-1].var.s);
+    last->els[last->n-1].type = 'p';
+    stkReleaseSpan(s, &span);
+    assert_true(stkIsEmpty(s));
+    assert_int_equal(s->nStrs, 0);
+#ifdef STK_STATS
+    {
+        stkStats_t st;
+
+        stkStats(s, &st);
+        assert_int_equal(st.strBytes, 0);
+    }
+#endif
+    assert_int_equal(stkStrRecycle(s, 1024), 0);
+    stkPushStr(s, "recycled");
+    stkPop(s);
+    stkDestroy(s);
+
+} /* test_span() */
+
+
 /** tests clear after several pushes */
 static void test_clear()
 {
@@ -180,6 +768,17 @@ int main(void)
         cmocka_unit_test(test_pushPop),      /* new, pushXxx, pop, isXxx, val, destroy */
         cmocka_unit_test(test_manyPushInts), /* new, pushInt, pop, valInt, isEmpty, destroy */
         cmocka_unit_test(test_manyPushStrs), /* new, pushStr, pop, valStr, isEmpty, destroy */
+        cmocka_unit_test(test_sizePeek),     /* new, pushInt, size, peek, pop, clear */
+        cmocka_unit_test(test_iter),         /* new, pushInt, pop, forEach, forEachRev */
+        cmocka_unit_test(test_mapReduce),    /* new, pushInt, pop, mapReduce */
+        cmocka_unit_test(test_find),         /* new, pushXxx, findXxx, countType, setSimd */
+        cmocka_unit_test(test_findTag),      /* pushDbl, findDbl, findInt, setSimd */
+        cmocka_unit_test(test_stats),        /* new, pushXxx, pop, stats, statsSample */
+        cmocka_unit_test(test_frames),       /* new, pushFrame, popFrame, frameEl, peek, forEachRev */
+        cmocka_unit_test(test_strRecycle),   /* new, pushStr, pop, strRecycle, trim, clear */
+        cmocka_unit_test(test_tune),         /* new, tune, tuneStats, pushInt, pop, pushFrame */
+        cmocka_unit_test(test_tuneFrames),   /* new, tune, pushFrame, popFrame, forEachRev */
+        cmocka_unit_test(test_span),         /* new, pushXxx, pushFrame, borrowSpan, releaseSpan */
         cmocka_unit_test(test_clear),        /* new, pushStr, clear, destroy */
         cmocka_unit_test(test_destroy),      /* new, pushStr, destroy */
         //cmocka_unit_test_setup_teardown(test_Xxx, setup, teardown),
@@ -0,0 +1,153 @@
+/**
+ * @file     stkpool_test.c
+ * @brief    stack pool unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <cmocka.h>
+
+#include "stkpool.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+/** number of threads to share a pool */
+#define THREADS 4
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests reuse of a released stack with its blocks */
+static void test_getPut()
+{
+    stkPool_t *pool = stkPoolNew(32, 1 << 20);
+    stk_t *s, *s2;
+    size_t nBlks;
+    int i;
+
+    assert_non_null(pool);
+    s = stkPoolGet(pool);
+    assert_non_null(s);
+    for(i = 0; i < 1000; i++)
+        stkPushInt(s, i);
+    stkPushFrame(s, 2, "ii", NULL);
+    assert_int_equal(stkStrRecycle(s, 1024), 0);
+    assert_int_equal(stkTune(s, 64, 4096), 0);
+    nBlks = s->nBlks;
+    stkPoolPut(pool, s);
+
+    s2 = stkPoolGet(pool);
+    assert_ptr_equal(s2, s);
+    assert_true(stkIsEmpty(s2));
+    assert_int_equal(stkSize(s2), 0);
+    assert_null(s2->frame);
+    assert_null(s2->recycle);
+    assert_null(s2->tune);
+    assert_int_equal(s2->blkSz, 32);
+    assert_int_equal(s2->nBlks, nBlks);
+
+    /* strings are popped one by one */
+    stkPushStr(s2, "str");
+    stkPushInt(s2, 1);
+    s = stkPoolGet(pool);
+    assert_ptr_not_equal(s, s2);
+    stkPoolPut(pool, s2);
+    stkPoolPut(pool, s);
+    assert_ptr_equal(stkPoolGet(pool), s);
+    s2 = stkPoolGet(pool);
+    assert_true(stkIsEmpty(s2));
+    stkPushInt(s2, 1);
+    assert_int_equal(stkValInt(s2), 1);
+
+    stkPoolPut(pool, s2); /* the other one left to destroy by caller */
+    stkPoolDestroy(pool);
+    stkDestroy(s);
+
+} /* test_getPut() */
+
+
+/** tests retained memory cap */
+static void test_cap()
+{
+    stkPool_t *pool = stkPoolNew(32, sizeof(stk_t) * 2);
+    stk_t *s = stkPoolGet(pool), *s2 = stkPoolGet(pool);
+    int i;
+
+    stkPushInt(s2, 1);       /* takes a block, exceeds the cap */
+    stkPoolPut(pool, s);
+    stkPoolPut(pool, s2);
+    assert_ptr_equal(stkPoolGet(pool), s);
+    s2 = stkPoolGet(pool);   /* new one */
+    assert_true(s2->nBlks == 0);
+
+    for(i = 0; i < MANY; i++)
+        stkPushInt(s2, i);
+    stkPoolPut(pool, s2);
+    stkPoolPut(pool, s);
+    stkPoolDestroy(pool);
+
+} /* test_cap() */
+
+
+/** gets, fills and releases stacks */
+static void *churn(void *arg)
+{
+    stkPool_t *pool = arg;
+    stk_t *s[3];
+    int i, j;
+
+    for(i = 0; i < MANY / 10; i++) {
+        for(j = 0; j < 3; j++) {
+            s[j] = stkPoolGet(pool);
+            stkPushInt(s[j], i);
+            if(i % 7 == 0)
+                stkPushStr(s[j], "str");
+        }
+        for(j = 0; j < 3; j++)
+            stkPoolPut(pool, s[j]);
+    }
+    return NULL;
+}
+
+/** tests pool shared by threads, caches handed over on thread exit */
+static void test_threads()
+{
+    stkPool_t *pool = stkPoolNew(32, 1 << 20);
+    pthread_t tids[THREADS];
+    int i;
+
+    for(i = 0; i < THREADS; i++)
+        assert_int_equal(pthread_create(&tids[i], NULL, churn, pool), 0);
+    churn(pool);
+    for(i = 0; i < THREADS; i++)
+        pthread_join(tids[i], NULL);
+
+    stkPoolDestroy(pool);
+
+} /* test_threads() */
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_getPut),  /* poolNew, poolGet, poolPut, poolDestroy */
+        cmocka_unit_test(test_cap),     /* poolNew, poolGet, poolPut, poolDestroy */
+        cmocka_unit_test(test_threads), /* poolGet, poolPut from threads */
+    };
+
+    return cmocka_run_group_tests_name("Stack pool tests", tests, NULL, NULL);
+}
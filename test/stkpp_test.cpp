@@ -0,0 +1,216 @@
+/**
+ * @file     stkpp_test.cpp
+ * @brief    C++ stack facade unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmocka.h>
+
+#include <memory>
+#include <string>
+
+#include "stk.hpp"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+/** counts copies and moves of itself */
+struct tracked
+{
+    static int copies;
+    static int moves;
+    int i;
+
+    explicit tracked(int i) : i(i) { }
+    tracked(const tracked &o) : i(o.i) { copies++; }
+    tracked(tracked &&o) noexcept : i(o.i) { moves++; }
+};
+
+int tracked::copies;
+int tracked::moves;
+
+
+/** stored inline, but its constructor may throw */
+struct picky
+{
+    int i;
+
+    explicit picky(int i) : i(i) { if(i < 0) throw i; }
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests values stored inline in the wrapper elements */
+static void test_inline(void **)
+{
+    stk::stack<int> s(32);
+    stk::stack<double> d(32);
+    int i;
+
+    assert_true(s.empty());
+    for(i = 0; i < MANY; i++)
+        s.push(i);
+    assert_int_equal(s.size(), MANY);
+    assert_true(stkIsInt(s.get()));
+
+    for(int v : s)
+        assert_int_equal(v, --i);
+    assert_int_equal(i, 0);
+
+    assert_int_equal(s.pop_value(), MANY-1);
+    assert_int_equal(s.top(), MANY-2);
+    s.clear();
+    assert_true(s.empty());
+    assert_true(stkIsEmpty(s.get()));
+
+    d.emplace(1.5);
+    assert_true(stkIsDbl(d.get()));
+    assert_true(stkValDbl(d.get()) == 1.5);
+
+} /* test_inline */
+
+
+/** tests moving strings in and out without copies */
+static void test_strings(void **)
+{
+    stk::stack<std::string> s(32);
+    std::string str(64, 'x');
+    const char *buf = str.data();
+    char num[32];
+    int i;
+
+    s.push(std::move(str));
+    assert_ptr_equal(s.top().data(), buf);
+    s.emplace(3, 'y');
+    assert_string_equal(s.top().c_str(), "yyy");
+    s.pop();
+
+    str = s.pop_value();
+    assert_ptr_equal(str.data(), buf);
+    assert_true(s.empty());
+
+    for(i = 0; i < MANY; i++) {
+        snprintf(num, sizeof(num), "%d", i);
+        s.emplace(num);
+    }
+    for(auto it = s.cbegin(); it != s.cend(); ++it) {
+        snprintf(num, sizeof(num), "%d", --i);
+        assert_string_equal(it->c_str(), num);
+    }
+    /* left to the destructor to free */
+
+} /* test_strings */
+
+
+/** tests move-only and copy counting types */
+static void test_moveOnly(void **)
+{
+    stk::stack<std::unique_ptr<int>> s(4);
+    stk::stack<tracked> t(4);
+    int i;
+
+    for(i = 0; i < 10; i++)
+        s.push(std::make_unique<int>(i));
+    std::unique_ptr<int> p = s.pop_value();
+    assert_int_equal(*p, 9);
+    assert_int_equal(*s.top(), 8);
+    assert_int_equal(s.size(), 9);
+
+    stk::stack<std::unique_ptr<int>> s2(std::move(s));
+    assert_int_equal(s2.size(), 9);
+    assert_true(s.empty());
+
+    tracked::copies = tracked::moves = 0;
+    t.emplace(1);
+    t.push(tracked(2));
+    tracked v = t.pop_value();
+    assert_int_equal(v.i, 2);
+    assert_int_equal(tracked::copies, 0);
+    assert_int_equal(tracked::moves, 2);
+
+} /* test_moveOnly */
+
+
+/** tests a throwing constructor leaves the stack as it was */
+static void test_emplaceThrow(void **)
+{
+    stk::stack<picky> s(4);
+    int i, thrown = 0;
+
+    for(i = 0; i < 10; i++)
+        s.emplace(i);
+    for(i = 0; i < 10; i++)
+        try { s.emplace(-1); } catch(int) { thrown++; }
+    assert_int_equal(thrown, 10);
+    assert_int_equal(s.size(), 10);
+    assert_int_equal(s.top().i, 9);
+    for(i = 9; i >= 0; i--)
+        assert_int_equal(s.pop_value().i, i);
+    assert_true(s.empty());
+
+} /* test_emplaceThrow */
+
+
+/** tests reusing stacks after being moved from */
+static void test_movedFrom(void **)
+{
+    stk::stack<int> s(4), s2(4);
+    stk::stack<std::string> t(4);
+    int i, n = 0;
+
+    for(i = 0; i < 10; i++)
+        s.push(i);
+    s2 = std::move(s);
+    assert_true(s.empty());
+    assert_int_equal(s.size(), 0);
+    assert_true(s.begin() == s.end());
+    s.clear();
+
+    for(i = 0; i < 10; i++)
+        s.push(i * 2);
+    for(int v : s)
+        assert_int_equal(v, 2 * (9 - n++));
+    assert_int_equal(n, 10);
+    assert_int_equal(s2.top(), 9);
+
+    t.emplace("a");
+    stk::stack<std::string> t2(std::move(t));
+    t.emplace("b");
+    t.push("c");
+    assert_string_equal(t.pop_value().c_str(), "c");
+    assert_string_equal(t.top().c_str(), "b");
+    assert_string_equal(t2.top().c_str(), "a");
+
+} /* test_movedFrom */
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_inline),   /* push, emplace, pop_value, iterate, clear */
+        cmocka_unit_test(test_strings),  /* push (move), emplace, pop_value, iterate */
+        cmocka_unit_test(test_moveOnly), /* push, pop_value, move construct */
+        cmocka_unit_test(test_emplaceThrow), /* emplace throwing */
+        cmocka_unit_test(test_movedFrom), /* push, iterate, clear after move */
+    };
+
+    return cmocka_run_group_tests_name("Stack facade tests", tests, NULL, NULL);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file     stkq_test.c
+ * @brief    queue and double-ended queue unit tests utilizing the cmocka
+ *           framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <cmocka.h>
+
+#include "stkq.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests first in - first out order across blocks */
+static void test_queue()
+{
+    stkq_t *q = stkqNew(7, 0);
+    char str[32];
+    int i, j;
+
+    assert_null(stkqNew(0, 0));
+    assert_null(stkqFront(q));
+    assert_null(stkqPop(q));
+    assert_null(stkqPush(q, 'x', 0));
+
+    /* interleaved, so blocks are recycled */
+    for(i = 0, j = 0; i < MANY; i++) {
+        snprintf(str, sizeof(str), "%d", i);
+        if(i % 3)
+            stkqPushInt(q, i);
+        else
+            stkqPushStr(q, str);
+        if(i % 2) {
+            if(j % 3) {
+                assert_int_equal(stkqFront(q)->var.i, j);
+            } else {
+                snprintf(str, sizeof(str), "%d", j);
+                assert_string_equal(stkqFront(q)->var.s, str);
+            }
+            stkqPop(q);
+            j++;
+        }
+    }
+    assert_int_equal(stkqSize(q), MANY - j);
+    stkqPushDbl(q, 1.5);
+    stkqPushChr(q, 'c');
+    stkqPushPtr(q, q);
+
+    for(; j < MANY; j++)
+        stkqPop(q);
+    assert_true(stkqFront(q)->var.d == 1.5);
+    stkqPop(q);
+    assert_int_equal(stkqFront(q)->var.c, 'c');
+    assert_ptr_equal(stkqPop(q)->var.p, q);
+    assert_null(stkqPop(q));
+    assert_int_equal(stkqSize(q), 0);
+
+    for(i = 0; i < 100; i++)
+        stkqPushStr(q, "left to destroy");
+    stkqDestroy(q);
+
+} /* test_queue() */
+
+
+/** pushes integers in order */
+static void *produce(void *arg)
+{
+    stkq_t *q = arg;
+    int i;
+
+    for(i = 0; i < MANY; i++)
+        if(i % 10)
+            stkqPushInt(q, i);
+        else
+            stkqPushStr(q, "ten");
+    return NULL;
+}
+
+/** tests single-producer single-consumer mode with threads */
+static void test_spsc()
+{
+    stkq_t *q = stkqNew(16, STKQ_SPSC);
+    pthread_t tid;
+    stkEl_t *el;
+    int i = 0;
+
+    /* ends written by different threads on different cache lines */
+    assert_int_equal((size_t)q % STKQ_LINE, 0);
+    assert_true(offsetof(stkq_t, head) / STKQ_LINE !=
+                offsetof(stkq_t, tail) / STKQ_LINE);
+    assert_int_equal(offsetof(stkq_t, nPopped) / STKQ_LINE,
+                     offsetof(stkq_t, head) / STKQ_LINE);
+    assert_int_equal(offsetof(stkq_t, nPushed) / STKQ_LINE,
+                     offsetof(stkq_t, tail) / STKQ_LINE);
+    assert_int_equal(offsetof(stkq_t, spare) / STKQ_LINE, 0);
+    assert_true(offsetof(stkq_t, head) / STKQ_LINE > 0);
+
+    assert_int_equal(pthread_create(&tid, NULL, produce, q), 0);
+    while(i < MANY)
+        if((el = stkqFront(q))) {
+            if(i % 10)
+                assert_int_equal(el->var.i, i);
+            else
+                assert_string_equal(el->var.s, "ten");
+            stkqPop(q);
+            i++;
+        }
+    pthread_join(tid, NULL);
+    assert_null(stkqFront(q));
+
+    produce(q);
+    stkqDestroy(q);
+
+} /* test_spsc() */
+
+
+/** tests double-ended queue at both ends across blocks */
+static void test_deque()
+{
+    stkdq_t *dq = stkdqNew(5);
+    int i;
+
+    assert_null(stkdqNew(0));
+    assert_null(stkdqPopFront(dq));
+    assert_null(stkdqPopBack(dq));
+
+    /* front gets negatives, back gets positives */
+    for(i = 1; i <= MANY; i++) {
+        stkdqPushFrontInt(dq, -i);
+        stkdqPushBackInt(dq, i);
+    }
+    assert_int_equal(stkdqSize(dq), 2*MANY);
+    assert_int_equal(dq->front->var.i, -MANY);
+    assert_int_equal(dq->back->var.i, MANY);
+
+    /* used as a stack from both ends */
+    for(i = MANY; i > 1; i--) {
+        assert_int_equal(stkdqPopFront(dq)->var.i, -(i-1));
+        assert_int_equal(stkdqPopBack(dq)->var.i, i-1);
+    }
+    assert_int_equal(stkdqPopFront(dq)->var.i, 1);
+    assert_null(stkdqPopBack(dq));
+    assert_int_equal(stkdqSize(dq), 0);
+
+    /* used as a queue, with strings */
+    for(i = 0; i < MANY; i++) {
+        stkdqPushBackStr(dq, "str");
+        if(i % 2)
+            stkdqPopFront(dq);
+    }
+    assert_string_equal(dq->front->var.s, "str");
+    assert_int_equal(stkdqSize(dq), MANY/2);
+    stkdqPushFront(dq, 'x', 0);
+    assert_int_equal(stkdqSize(dq), MANY/2);
+    stkdqDestroy(dq);
+
+} /* test_deque() */
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_queue), /* qNew, qPushXxx, qFront, qPop, qSize, qDestroy */
+        cmocka_unit_test(test_spsc),  /* qNew, qPushXxx, qFront, qPop from threads */
+        cmocka_unit_test(test_deque), /* dqNew, dqPushXxx, dqPopXxx, dqSize, dqDestroy */
+    };
+
+    return cmocka_run_group_tests_name("Queue tests", tests, NULL, NULL);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file     stkr_test.c
+ * @brief    bounded stack unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmocka.h>
+
+#include "stkr.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 100000
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests typed pushes and pops within capacity */
+static void test_pushPop()
+{
+    stkr_t *r = stkrNew(8);
+
+    assert_null(stkrNew(0));
+    assert_non_null(r);
+    assert_true(stkIsEmpty(r));
+    assert_null(stkrPop(r));
+
+    stkrPushInt(r, 1);
+    stkrPushStr(r, "2");
+    stkrPushDbl(r, 3.0);
+    stkrPushChr(r, '4');
+    stkrPushPtr(r, r);
+    assert_null(stkrPush(r, 'x', 0));
+    assert_int_equal(stkSize(r), 5);
+
+    assert_true(stkIsPtr(r));
+    assert_ptr_equal(stkValPtr(r), r);
+    stkrPop(r);
+    assert_int_equal(stkValChr(r), '4');
+    stkrPop(r);
+    assert_true(stkValDbl(r) == 3.0);
+    assert_string_equal(stkrPeek(r, 1)->var.s, "2");
+    assert_int_equal(stkrPeek(r, 2)->var.i, 1);
+    assert_null(stkrPeek(r, 3));
+    stkrPop(r);
+    assert_string_equal(stkValStr(r), "2");
+    stkrPop(r);
+    assert_int_equal(stkValInt(r), 1);
+    assert_null(stkrPop(r));
+    assert_true(stkIsEmpty(r));
+    assert_int_equal(r->dropped, 0);
+
+    stkrDestroy(r);
+
+} /* test_pushPop() */
+
+
+/** tests dropping of the bottom elements when full */
+static void test_overwrite()
+{
+    stkr_t *r = stkrNew(10);
+    char str[32];
+    int i;
+
+    for(i = 0; i < MANY; i++) {
+        snprintf(str, sizeof(str), "%d", i);
+        if(i % 2)
+            stkrPushStr(r, str);
+        else
+            stkrPushInt(r, i);
+    }
+    assert_int_equal(stkSize(r), 10);
+    assert_int_equal(r->dropped, MANY - 10);
+    assert_int_equal(stkrPeek(r, 9)->var.i, MANY - 10);
+
+    /* pop some, then wrap around again */
+    for(i = 0; i < 5; i++)
+        stkrPop(r);
+    assert_int_equal(stkValInt(r), MANY - 6);
+    for(i = 0; i < 7; i++)
+        stkrPushInt(r, -i);
+    assert_int_equal(stkSize(r), 10);
+    assert_int_equal(stkrPeek(r, 0)->var.i, -6);
+    assert_int_equal(stkrPeek(r, 9)->var.i, MANY - 8);
+
+    i = 0;
+    while(stkrPop(r))
+        i++;
+    assert_int_equal(i, 9);
+
+    for(i = 0; i < 25; i++)
+        stkrPushStr(r, "left to destroy");
+    stkrDestroy(r);
+
+} /* test_overwrite() */
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_pushPop),   /* new, pushXxx, pop, peek, isEmpty, destroy */
+        cmocka_unit_test(test_overwrite), /* new, pushXxx, pop, peek, destroy */
+    };
+
+    return cmocka_run_group_tests_name("Bounded stack tests", tests, NULL, NULL);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file     ulist_test.c
+ * @brief    unrolled list unit tests utilizing the cmocka framework
+ * @author   Tamas Dezso
+ * @date     October 18, 2026
+ * @version  1.0
+ */
+
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "ulist.h"
+
+
+/* ----- macros ------------------------------------------------------------ */
+
+
+/** exact meaning of many when it comes to mass testing */
+#define MANY 10000
+
+/** entries per node */
+#define K 8
+
+#define NUMCMP(X, Y) (((X) > (Y)) - ((Y) > (X)))
+
+/** counts nodes of an unrolled list */
+#define NODES(ul)                                                             \
+({                                                                            \
+        ULIST_NODE(ul) __n;                                                   \
+        int __c = 0;                                                          \
+                                                                              \
+        for(__n = (ul).head; __n; __n = __n->next)                            \
+            __c++;                                                            \
+        __c;                                                                  \
+})
+
+
+/* ----- types ------------------------------------------------------------- */
+
+
+typedef struct pair_t pair_t;
+struct pair_t
+{
+    int key;
+    int val;
+};
+
+
+/* ----- functions --------------------------------------------------------- */
+
+
+/** tests additions at both ends, iteration, find and removal at ends */
+static void test_ends()
+{
+    ULIST(int, K) ul = ULIST_INIT;
+    ULIST_NODE(ul) node;
+    int *pos, i, n;
+
+    assert_null(ulistFront(ul));
+    assert_null(ulistFind(ul, NUMCMP, [0], 0));
+    n = 0;
+    ulistForEach(pos, node, ul)
+        n++;
+    assert_int_equal(n, 0);
+
+    /* -MANY..-1 in front, 0..MANY-1 at back */
+    for(i = 0; i < MANY; i++) {
+        assert_non_null(ulistAddTail(ul, i));
+        assert_non_null(ulistAdd(ul, -i - 1));
+    }
+    assert_int_equal(ulistSize(ul), 2 * MANY);
+    assert_int_equal(*ulistFront(ul), -MANY);
+    assert_int_equal(*ulistBack(ul), MANY - 1);
+    assert_true(NODES(ul) <= 2 * MANY / K + 2);
+
+    n = -MANY;
+    ulistForEach(pos, node, ul)
+        assert_int_equal(*pos, n++);
+    assert_int_equal(n, MANY);
+    pos = ulistFind(ul, NUMCMP, [0], 123);
+    assert_non_null(pos);
+    assert_int_equal(*pos, 123);
+    assert_null(ulistFind(ul, NUMCMP, [0], MANY));
+
+    /* drained from both ends */
+    for(i = 0; i < MANY - 1; i++) {
+        assert_int_equal(*ulistDelFront(ul), -MANY + i + 1);
+        assert_int_equal(*ulistDelBack(ul), MANY - i - 2);
+    }
+    assert_int_equal(ulistSize(ul), 2);
+    assert_int_equal(*ulistDelFront(ul), 0);
+    assert_null(ulistDelBack(ul));
+    assert_null(ul.head);
+    assert_null(ul.tail);
+    assert_null(ulistDelFront(ul));
+    ulistDestroy(ul);
+}
+
+/** tests deletions with compaction */
+static void test_del()
+{
+    ULIST(pair_t, K) ul = ULIST_INIT;
+    ULIST_NODE(ul) node;
+    pair_t *pos, p;
+    int i, n;
+
+    for(i = 0; i < MANY; i++) {
+        p.key = i;
+        p.val = i % 3;
+        ulistAddTail(ul, p);
+    }
+
+    /* one by one, found and removed */
+    for(i = 0; i < MANY; i += 7) {
+        ulistForEach(pos, node, ul)
+            if(pos->key == i)
+                break;
+        assert_non_null(pos);
+        ulistDel(ul, node, pos);
+    }
+    assert_int_equal(ulistSize(ul), MANY - (MANY + 6) / 7);
+    n = 0;
+    ulistForEach(pos, node, ul) {
+        assert_true(pos->key % 7);
+        n++;
+    }
+    assert_int_equal(n, ulistSize(ul));
+
+    /* two thirds removed in a pass, nodes merged */
+    ulistDelMatch(ul, NUMCMP, ->val, 0);
+    ulistDelMatch(ul, NUMCMP, ->val, 1);
+    n = 0;
+    ulistForEach(pos, node, ul) {
+        assert_int_equal(pos->val, 2);
+        assert_true(pos->key % 7);
+        n++;
+    }
+    assert_int_equal(n, ulistSize(ul));
+    assert_true(NODES(ul) <= 2 * (n + K - 1) / K);
+
+    ulistDelMatch(ul, NUMCMP, ->val, 2);
+    assert_int_equal(ulistSize(ul), 0);
+    assert_null(ul.head);
+    assert_null(ul.tail);
+    ulistDestroy(ul);
+}
+
+/** tests nodes of a single entry */
+static void test_single()
+{
+    ULIST(int, 1) ul = ULIST_INIT;
+    ULIST_NODE(ul) node;
+    int *pos, i, n;
+
+    assert_int_equal(*ulistAdd(ul, 0), 0);
+    assert_int_equal(*ulistAdd(ul, -1), -1);
+    assert_int_equal(*ulistAddTail(ul, 1), 1);
+    for(i = 2; i < 10; i++) {
+        ulistAddTail(ul, i);
+        ulistAdd(ul, -i);
+    }
+    assert_int_equal(ulistSize(ul), 19);
+    assert_int_equal(NODES(ul), 19);
+    n = -9;
+    ulistForEach(pos, node, ul)
+        assert_int_equal(*pos, n++);
+    assert_int_equal(n, 10);
+
+    ulistDelMatch(ul, NUMCMP, [0], 0);
+    assert_null(ulistFind(ul, NUMCMP, [0], 0));
+    ulistForEach(pos, node, ul)
+        if(*pos == 5)
+            break;
+    ulistDel(ul, node, pos);
+    assert_int_equal(*ulistDelFront(ul), -8);
+    assert_int_equal(*ulistDelBack(ul), 8);
+    assert_int_equal(ulistSize(ul), 15);
+    assert_int_equal(NODES(ul), 15);
+    ulistDestroy(ul);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_ends),   /* add, addTail, forEach, find, delFront, delBack */
+        cmocka_unit_test(test_del),    /* addTail, forEach, del, delMatch, destroy */
+        cmocka_unit_test(test_single), /* add, addTail, del, delMatch with k = 1 */
+    };
+
+    return cmocka_run_group_tests_name("Unrolled list tests", tests, NULL, NULL);
+}